@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "cache_counter.hpp"
+#include "model.hpp"
+
+// Mesure le coût de la consommation de la végétation par le front suivant dans les pas Scatter :
+//   - en deux passes (Model::TwoPasses) : seconde passe sur tout le front suivant (indice et position de chaque
+//                                         case) ;
+//   - en une passe   (Model::Fused)     : les cases entrées à 255 consomment pendant le parcours principal, alors que
+//                                         la ligne de la carte est en cache ; il ne reste que les foyers affaiblis.
+// Une vraie simulation est menée jusqu'au pas demandé et son état est gardé. Chaque répétition repart de cet état
+// (copie du modèle, hors chronomètre) et mesure des pas Scatter complets, les deux versions à tour de rôle. Les
+// défauts de cache viennent des compteurs matériels du processeur quand le système les rend accessibles (voir
+// cache_counter.hpp), sinon seule la durée est donnée. Les deux versions doivent aboutir à la même empreinte.
+namespace
+{
+    struct Measure
+    {
+        double        seconds    = 0.;
+        std::size_t   cell_steps = 0; // Cases parcourues par les pas mesurés (Model::processed_cells)
+        std::uint64_t l1_misses  = 0, llc_misses = 0;
+        bool          counted    = false;
+        std::uint64_t digest     = 0;
+    };
+}
+
+int main( int nargs, char* args[] )
+{
+    unsigned    geometry    = nargs > 1 ? unsigned(std::stoul(args[1])) : 1024u;
+    std::size_t time_step   = nargs > 2 ? std::stoul(args[2]) : geometry / 2;
+    std::size_t nb_steps    = nargs > 3 ? std::stoul(args[3]) : 5u;
+    std::size_t repetitions = nargs > 4 ? std::stoul(args[4]) : 20u;
+    if ((geometry < 2) || (nb_steps == 0) || (repetitions == 0))
+    {
+        std::cerr << "Usage : bench_front [NB_CASES_PAR_DIRECTION [PAS_DE_TEMPS [PAS_MESURES [REPETITIONS]]]]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Model saved(1., geometry, {5., 3.}, {geometry / 2, geometry / 2});
+    saved.set_update_kernel(Model::Scatter);
+    std::vector<Model::StepSummary> summaries;
+    if (!saved.advance(time_step, summaries) || (saved.time_step() < time_step))
+    {
+        std::cerr << "Le feu est éteint au pas " << saved.time_step() << " : rien à mesurer." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+#if defined(__linux__)
+    CacheCounter l1(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    CacheCounter llc(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#else
+    CacheCounter l1(0, 0), llc(0, 0);
+#endif
+    Model::Consumption const consumptions[] = {Model::TwoPasses, Model::Fused};
+    Measure measures[2];
+    Model model(saved);
+    for (std::size_t r = 0; r < repetitions; ++r)
+        for (std::size_t k = 0; k < 2; ++k)
+        {
+            std::size_t v = (r % 2 == 0) ? k : 1 - k; // Chaque version passe une fois sur deux en premier
+            model = saved;
+            model.set_consumption(consumptions[v]);
+            l1.start();
+            llc.start();
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t s = 0; s < nb_steps; ++s)
+                model.update();
+            measures[v].seconds    += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            measures[v].l1_misses  += l1.stop();
+            measures[v].llc_misses += llc.stop();
+            measures[v].counted     = l1.available() && llc.available();
+            measures[v].cell_steps += model.processed_cells() - saved.processed_cells();
+            measures[v].digest      = model.digest();
+        }
+
+    std::cout << "Carte " << geometry << "x" << geometry << ", parcours Scatter, pas " << saved.time_step() << " à "
+              << saved.time_step() + nb_steps << " (" << summaries.back().front_size << " cases en feu au départ), "
+              << repetitions << " répétitions" << std::endl;
+    char const* names[] = {"Deux passes", "Une passe  "};
+    for (std::size_t v = 0; v < 2; ++v)
+    {
+        Measure const& measure = measures[v];
+        double cell_steps = double(std::max<std::size_t>(measure.cell_steps, 1));
+        std::cout << names[v] << " : " << measure.seconds * 1e3 / double(repetitions * nb_steps) << " ms par pas, "
+                  << measure.seconds * 1e9 / cell_steps << " ns par case";
+        if (measure.counted)
+            std::cout << ", défauts de cache par case : L1 " << double(measure.l1_misses) / cell_steps
+                      << ", dernier niveau " << double(measure.llc_misses) / cell_steps;
+        else
+            std::cout << " (compteurs de cache indisponibles)";
+        std::cout << " [empreinte " << measure.digest << "]" << std::endl;
+    }
+    if (measures[0].digest != measures[1].digest)
+    {
+        std::cerr << "Les deux versions n'aboutissent pas au même état !" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
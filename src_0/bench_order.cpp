@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "cache_counter.hpp"
+#include "model.hpp"
+
+// Mesure l'effet de l'ordre du front sur les pas Scatter : la même simulation (parcours Scatter) est menée avec
+// chaque ordre et on mesure les derniers pas de temps. Les défauts de cache viennent des compteurs matériels du
+// processeur quand le système les rend accessibles (perf_event_open sous Linux), sinon seule la durée est donnée.
+namespace
+{
+    struct Measure
+    {
+        double        seconds    = 0.;
+        std::size_t   cell_steps = 0; // Somme des tailles du front sur les pas mesurés
+        std::uint64_t l1_misses  = 0, llc_misses = 0;
+        bool          counted    = false;
+        std::uint64_t digest     = 0;
+    };
+
+    Measure run( unsigned t_geometry, std::size_t t_nb_steps, std::size_t t_window, Model::FrontOrder t_order )
+    {
+        Model model(1., t_geometry, {5., 3.}, {t_geometry / 2, t_geometry / 2});
+        model.set_update_kernel(Model::Scatter);
+        model.set_front_order(t_order);
+        while ((model.time_step() + t_window < t_nb_steps) && model.update()) {}
+
+#if defined(__linux__)
+        CacheCounter l1(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        CacheCounter llc(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#else
+        CacheCounter l1(0, 0), llc(0, 0);
+#endif
+        Measure result;
+        std::vector<Model::StepSummary> summaries;
+        l1.start();
+        llc.start();
+        auto start = std::chrono::steady_clock::now();
+        model.advance(t_nb_steps - model.time_step(), summaries);
+        result.seconds    = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.l1_misses  = l1.stop();
+        result.llc_misses = llc.stop();
+        result.counted    = l1.available() && llc.available();
+        for (auto const& summary : summaries)
+            result.cell_steps += summary.front_size;
+        result.digest = model.digest();
+        return result;
+    }
+}
+
+int main( int nargs, char* args[] )
+{
+    unsigned    geometry = nargs > 1 ? unsigned(std::stoul(args[1])) : 8192u;
+    std::size_t nb_steps = nargs > 2 ? std::stoul(args[2]) : geometry / 8;
+    std::size_t window   = nargs > 3 ? std::stoul(args[3]) : 100u;
+    if ((geometry < 2) || (window == 0) || (window > nb_steps))
+    {
+        std::cerr << "Usage : bench_order [NB_CASES_PAR_DIRECTION [PAS_DE_TEMPS [PAS_MESURES]]]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Carte " << geometry << "x" << geometry << ", parcours Scatter, pas " << nb_steps - window
+              << " à " << nb_steps << std::endl;
+    for (auto const& [name, order] : {std::pair<char const*, Model::FrontOrder>{"Insertion", Model::Insertion},
+                                      std::pair<char const*, Model::FrontOrder>{"Morton   ", Model::Morton},
+                                      std::pair<char const*, Model::FrontOrder>{"Lignes   ", Model::Rows}})
+    {
+        Measure measure = run(geometry, nb_steps, window, order);
+        double cell_steps = double(std::max<std::size_t>(measure.cell_steps, 1));
+        std::cout << name << " : " << measure.seconds * 1e3 / double(window) << " ms par pas, "
+                  << measure.seconds * 1e9 / cell_steps << " ns par foyer";
+        if (measure.counted)
+            std::cout << ", défauts de cache par foyer : L1 " << double(measure.l1_misses) / cell_steps
+                      << ", dernier niveau " << double(measure.llc_misses) / cell_steps;
+        else
+            std::cout << " (compteurs de cache indisponibles)";
+        std::cout << " [empreinte " << measure.digest << "]" << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Compteur matériel du processeur (défauts de cache par exemple), pour les programmes de mesure.
+ *
+ * Ouvert avec perf_event_open sous Linux quand le système le permet ; sinon available() est faux et le compteur
+ * reste à zéro.
+ */
+class CacheCounter
+{
+public:
+#if defined(__linux__)
+    CacheCounter( std::uint32_t t_type, std::uint64_t t_config )
+    {
+        perf_event_attr attributes{};
+        attributes.size           = sizeof(attributes);
+        attributes.type           = t_type;
+        attributes.config         = t_config;
+        attributes.disabled       = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv     = 1;
+        m_descriptor = int(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+    ~CacheCounter() { if (m_descriptor >= 0) close(m_descriptor); }
+
+    bool available() const { return m_descriptor >= 0; }
+    void start()
+    {
+        if (!available()) return;
+        ioctl(m_descriptor, PERF_EVENT_IOC_RESET, 0);
+        ioctl(m_descriptor, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    std::uint64_t stop()
+    {
+        std::uint64_t count = 0;
+        if (!available()) return count;
+        ioctl(m_descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(m_descriptor, &count, sizeof(count)) != sizeof(count)) count = 0;
+        return count;
+    }
+#else
+    CacheCounter( std::uint32_t, std::uint64_t ) {}
+    bool available() const { return false; }
+    void start() {}
+    std::uint64_t stop() { return 0; }
+#endif
+    CacheCounter( CacheCounter const & ) = delete;
+    CacheCounter& operator = ( CacheCounter const & ) = delete;
+
+private:
+    int m_descriptor = -1;
+};
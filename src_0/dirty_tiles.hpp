@@ -0,0 +1,67 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Tuiles d'une carte dont une case a pu changer, pour ne redessiner que celles-ci.
+ *
+ * La carte (rows x columns cases) est découpée en tuiles de tile_size x tile_size cases, rangées ligne par ligne
+ * comme les tuiles actives du modèle (un octet par tuile, non nul si la tuile est modifiée). À la construction,
+ * toutes les tuiles sont marquées : le premier affichage est complet.
+ */
+class DirtyTiles
+{
+public:
+    DirtyTiles( unsigned t_rows, unsigned t_columns, unsigned t_tile_size )
+        :   m_rows(t_rows), m_columns(t_columns), m_tile_size(t_tile_size),
+            m_tile_rows((t_rows + t_tile_size - 1) / t_tile_size),
+            m_tile_columns((t_columns + t_tile_size - 1) / t_tile_size),
+            m_tiles(std::size_t(m_tile_rows) * m_tile_columns, 1u)
+    {}
+
+    unsigned rows        () const { return m_rows;         }
+    unsigned columns     () const { return m_columns;      }
+    unsigned tile_rows   () const { return m_tile_rows;    }
+    unsigned tile_columns() const { return m_tile_columns; }
+    unsigned tile_size   () const { return m_tile_size;    }
+
+    bool dirty( unsigned t_tile_row, unsigned t_tile_column ) const
+    {
+        return m_tiles[std::size_t(t_tile_row) * m_tile_columns + t_tile_column] != 0;
+    }
+    std::size_t count() const { return std::size_t(std::count(m_tiles.begin(), m_tiles.end(), 1u)); }
+
+    void mark_all() { std::fill(m_tiles.begin(), m_tiles.end(), 1u); }
+    void clear   () { std::fill(m_tiles.begin(), m_tiles.end(), 0u); }
+    // Ajoute les tuiles non nulles de t_tiles (même découpage, un octet par tuile)
+    void merge( std::vector<std::uint8_t> const & t_tiles )
+    {
+        for (std::size_t tile = 0; tile < m_tiles.size(); ++tile)
+            m_tiles[tile] |= std::uint8_t(t_tiles[tile] != 0);
+    }
+
+    // Appelle t_function(row_begin, row_end, column_begin, column_end) pour chaque suite de tuiles modifiées
+    // voisines de la ligne de tuiles t_tile_row (bornes de fin exclues, en cases, limitées à la carte)
+    template<typename Function>
+    void for_each_span( unsigned t_tile_row, Function && t_function ) const
+    {
+        unsigned row_begin = t_tile_row * m_tile_size;
+        unsigned row_end   = std::min(row_begin + m_tile_size, m_rows);
+        for (unsigned tile_column = 0; tile_column < m_tile_columns; ++tile_column)
+        {
+            if (!dirty(t_tile_row, tile_column))
+                continue;
+            unsigned first = tile_column;
+            while ((tile_column + 1 < m_tile_columns) && dirty(t_tile_row, tile_column + 1))
+                ++tile_column;
+            t_function(row_begin, row_end, first * m_tile_size, std::min((tile_column + 1) * m_tile_size, m_columns));
+        }
+    }
+
+private:
+    unsigned m_rows, m_columns, m_tile_size;
+    unsigned m_tile_rows, m_tile_columns;
+    std::vector<std::uint8_t> m_tiles;
+};
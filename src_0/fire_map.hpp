@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief Carte des intensités du feu.
+ *
+ * Une intensité vaut toujours 255 >> k (0 <= k <= 8) : une case s'allume à 255 puis son intensité est divisée
+ * par deux à chaque affaiblissement. Compilée avec PACKED_FIRE_MAP, la carte range pour chaque case le code 8 - k
+ * sur 4 bits (0 pour une case éteinte), deux cases par octet : la mémoire parcourue par pas de temps est divisée
+ * par deux. Sinon elle garde un octet par case. Dans les deux cas, get et set travaillent sur l'intensité 0..255.
+ */
+class FireMap
+{
+public:
+    explicit FireMap( std::size_t t_nb_cells )
+#if defined(PACKED_FIRE_MAP)
+        :   m_data((t_nb_cells + 1) / 2, 0u),
+#else
+        :   m_data(t_nb_cells, 0u),
+#endif
+            m_size(t_nb_cells)
+    {}
+
+    std::size_t size() const { return m_size; }
+#if defined(PACKED_FIRE_MAP)
+    static constexpr bool packed = true;
+#else
+    static constexpr bool packed = false;
+#endif
+    // Octets bruts de la carte, à relire avec value
+    std::uint8_t const * data() const { return m_data.data(); }
+
+#if defined(PACKED_FIRE_MAP)
+    std::uint8_t get( std::size_t t_position ) const { return value(m_data.data(), t_position); }
+    // Intensité de la case t_position dans les octets bruts t_data d'une carte
+    static std::uint8_t value( std::uint8_t const * t_data, std::size_t t_position )
+    {
+        return decode((t_data[t_position >> 1] >> ((t_position & 1) * 4)) & 0xFu);
+    }
+
+    void set( std::size_t t_position, std::uint8_t t_intensity )
+    {
+        unsigned shift = (t_position & 1) * 4;
+        std::uint8_t& pair = m_data[t_position >> 1];
+        pair = std::uint8_t((pair & ~(0xFu << shift)) | (encode(t_intensity) << shift));
+    }
+
+    // Recopie les cases [t_first, t_first + t_count) de t_other
+    void copy( FireMap const & t_other, std::size_t t_first, std::size_t t_count )
+    {
+        if ((t_count > 0) && (t_first & 1))
+        {
+            set(t_first, t_other.get(t_first));
+            ++t_first; --t_count;
+        }
+        std::copy_n(t_other.m_data.begin() + t_first / 2, t_count / 2, m_data.begin() + t_first / 2);
+        if (t_count & 1)
+            set(t_first + t_count - 1, t_other.get(t_first + t_count - 1));
+    }
+#else
+    std::uint8_t get( std::size_t t_position ) const { return m_data[t_position]; }
+    static std::uint8_t value( std::uint8_t const * t_data, std::size_t t_position ) { return t_data[t_position]; }
+    void set( std::size_t t_position, std::uint8_t t_intensity ) { m_data[t_position] = t_intensity; }
+
+    // Recopie les cases [t_first, t_first + t_count) de t_other
+    void copy( FireMap const & t_other, std::size_t t_first, std::size_t t_count )
+    {
+        std::copy_n(t_other.m_data.begin() + t_first, t_count, m_data.begin() + t_first);
+    }
+#endif
+
+private:
+#if defined(PACKED_FIRE_MAP)
+    // 255 >> k <-> 8 - k, soit le nombre de bits significatifs de l'intensité
+    static std::uint8_t encode( std::uint8_t t_intensity )
+    {
+        return (t_intensity > 0) ? std::uint8_t(32 - __builtin_clz(t_intensity)) : 0u;
+    }
+    static std::uint8_t decode( unsigned t_code )
+    {
+        return std::uint8_t(0xFFu >> (8 - t_code));
+    }
+#endif
+
+    std::vector<std::uint8_t> m_data;
+    std::size_t               m_size;
+};
@@ -0,0 +1,232 @@
+#include <cstdlib>
+#include <string>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#include "front_kernel.hpp"
+
+using namespace std::string_literals;
+
+namespace
+{
+    constexpr std::uint64_t modulus = 2147483647u; // 2^31 - 1
+    // Multiplicateurs des germes : voisins sud-nord, nord-sud, est-ouest, ouest-est puis affaiblissement
+    constexpr std::uint64_t multipliers[front_kernel::nb_draws] = { 1u, 13427u, 13427u*13427u,
+                                                                    13427ull*13427u*13427u, 52513u };
+
+    // Même calcul que pseudo_random_raw dans model.cpp
+    std::uint_fast32_t draw( std::size_t index, std::size_t time_step )
+    {
+        std::uint_fast32_t xi = std::uint_fast32_t(index * (time_step + 1));
+        return (48271 * xi) % 2147483647;
+    }
+
+    // Cases first à count-1 du lot (reste des versions vectorielles)
+    void scalar_tail( std::uint32_t const * cells, std::uint32_t const * thresholds, std::size_t count,
+                      std::size_t first, std::size_t time_step, std::uint8_t * masks )
+    {
+        for (std::size_t i = first; i < count; ++i)
+        {
+            std::uint8_t mask = 0;
+            for (std::size_t k = 0; k < front_kernel::nb_draws; ++k)
+                if (draw(cells[i] * multipliers[k] + time_step, time_step) < thresholds[k*count + i])
+                    mask |= std::uint8_t(1u << k);
+            masks[i] = mask;
+        }
+    }
+
+    void scalar_kernel( std::uint32_t const * cells, std::uint32_t const * thresholds, std::size_t count,
+                        std::size_t time_step, std::uint8_t * masks )
+    {
+        scalar_tail(cells, thresholds, count, 0, time_step, masks);
+    }
+
+#if defined(__x86_64__)
+    // Les versions vectorielles travaillent sur des entiers 64 bits : x*y (mod 2^64) est reconstruit à partir
+    // des produits 32x32 -> 64 bits, et x mod (2^31-1) par repliement puisque 2^31 = 1 (mod 2^31-1).
+    // ----------------------------------------------------------------------------------------------------------------
+    __attribute__((target("sse4.2")))
+    __m128i mul64_sse( __m128i x, __m128i y )
+    {
+        __m128i lo    = _mm_mul_epu32(x, y);
+        __m128i cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(x, 32), y), _mm_mul_epu32(x, _mm_srli_epi64(y, 32)));
+        return _mm_add_epi64(lo, _mm_slli_epi64(cross, 32));
+    }
+
+    __attribute__((target("sse4.2")))
+    __m128i mod_sse( __m128i x )
+    {
+        const __m128i m = _mm_set1_epi64x(modulus);
+        x = _mm_add_epi64(_mm_and_si128(x, m), _mm_srli_epi64(x, 31));
+        x = _mm_add_epi64(_mm_and_si128(x, m), _mm_srli_epi64(x, 31));
+        return _mm_sub_epi64(x, _mm_andnot_si128(_mm_cmpgt_epi64(m, x), m));
+    }
+
+    __attribute__((target("sse4.2")))
+    void sse42_kernel( std::uint32_t const * cells, std::uint32_t const * thresholds, std::size_t count,
+                       std::size_t time_step, std::uint8_t * masks )
+    {
+        const __m128i t   = _mm_set1_epi64x(time_step);
+        const __m128i tp1 = _mm_set1_epi64x(time_step + 1);
+        const __m128i a   = _mm_set1_epi64x(48271);
+        std::size_t i = 0;
+        for (; i + 2 <= count; i += 2)
+        {
+            __m128i f = _mm_cvtepu32_epi64(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(cells + i)));
+            unsigned mask[2] = { 0, 0 };
+            for (std::size_t k = 0; k < front_kernel::nb_draws; ++k)
+            {
+                __m128i seed = _mm_add_epi64(mul64_sse(f, _mm_set1_epi64x(multipliers[k])), t);
+                __m128i r    = mod_sse(mul64_sse(mul64_sse(seed, tp1), a));
+                __m128i thr  = _mm_cvtepu32_epi64(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(thresholds + k*count + i)));
+                int below    = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(thr, r)));
+                mask[0] |= unsigned(below & 1) << k;
+                mask[1] |= unsigned((below >> 1) & 1) << k;
+            }
+            masks[i]   = std::uint8_t(mask[0]);
+            masks[i+1] = std::uint8_t(mask[1]);
+        }
+        scalar_tail(cells, thresholds, count, i, time_step, masks);
+    }
+    // ----------------------------------------------------------------------------------------------------------------
+    __attribute__((target("avx2")))
+    __m256i mul64_avx2( __m256i x, __m256i y )
+    {
+        __m256i lo    = _mm256_mul_epu32(x, y);
+        __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), y),
+                                         _mm256_mul_epu32(x, _mm256_srli_epi64(y, 32)));
+        return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+    }
+
+    __attribute__((target("avx2")))
+    __m256i mod_avx2( __m256i x )
+    {
+        const __m256i m = _mm256_set1_epi64x(modulus);
+        x = _mm256_add_epi64(_mm256_and_si256(x, m), _mm256_srli_epi64(x, 31));
+        x = _mm256_add_epi64(_mm256_and_si256(x, m), _mm256_srli_epi64(x, 31));
+        return _mm256_sub_epi64(x, _mm256_andnot_si256(_mm256_cmpgt_epi64(m, x), m));
+    }
+
+    __attribute__((target("avx2")))
+    void avx2_kernel( std::uint32_t const * cells, std::uint32_t const * thresholds, std::size_t count,
+                      std::size_t time_step, std::uint8_t * masks )
+    {
+        const __m256i t   = _mm256_set1_epi64x(time_step);
+        const __m256i tp1 = _mm256_set1_epi64x(time_step + 1);
+        const __m256i a   = _mm256_set1_epi64x(48271);
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256i f = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<__m128i const*>(cells + i)));
+            unsigned mask[4] = { 0, 0, 0, 0 };
+            for (std::size_t k = 0; k < front_kernel::nb_draws; ++k)
+            {
+                __m256i seed = _mm256_add_epi64(mul64_avx2(f, _mm256_set1_epi64x(multipliers[k])), t);
+                __m256i r    = mod_avx2(mul64_avx2(mul64_avx2(seed, tp1), a));
+                __m256i thr  = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<__m128i const*>(thresholds + k*count + i)));
+                int below    = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(thr, r)));
+                for (int lane = 0; lane < 4; ++lane)
+                    mask[lane] |= unsigned((below >> lane) & 1) << k;
+            }
+            for (int lane = 0; lane < 4; ++lane)
+                masks[i + lane] = std::uint8_t(mask[lane]);
+        }
+        scalar_tail(cells, thresholds, count, i, time_step, masks);
+    }
+    // ----------------------------------------------------------------------------------------------------------------
+    // Les intrinsèques AVX-512 de GCC partent d'un registre volontairement non initialisé (_mm512_undefined_epi32)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    __attribute__((target("avx512f")))
+    __m512i mul64_avx512( __m512i x, __m512i y )
+    {
+        __m512i lo    = _mm512_mul_epu32(x, y);
+        __m512i cross = _mm512_add_epi64(_mm512_mul_epu32(_mm512_srli_epi64(x, 32), y),
+                                         _mm512_mul_epu32(x, _mm512_srli_epi64(y, 32)));
+        return _mm512_add_epi64(lo, _mm512_slli_epi64(cross, 32));
+    }
+
+    __attribute__((target("avx512f")))
+    void avx512_kernel( std::uint32_t const * cells, std::uint32_t const * thresholds, std::size_t count,
+                        std::size_t time_step, std::uint8_t * masks )
+    {
+        const __m512i t   = _mm512_set1_epi64(time_step);
+        const __m512i tp1 = _mm512_set1_epi64(time_step + 1);
+        const __m512i a   = _mm512_set1_epi64(48271);
+        const __m512i m   = _mm512_set1_epi64(modulus);
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m512i f = _mm512_cvtepu32_epi64(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(cells + i)));
+            unsigned mask[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+            for (std::size_t k = 0; k < front_kernel::nb_draws; ++k)
+            {
+                __m512i seed = _mm512_add_epi64(mul64_avx512(f, _mm512_set1_epi64(multipliers[k])), t);
+                __m512i r    = mul64_avx512(mul64_avx512(seed, tp1), a);
+                r = _mm512_add_epi64(_mm512_and_si512(r, m), _mm512_srli_epi64(r, 31));
+                r = _mm512_add_epi64(_mm512_and_si512(r, m), _mm512_srli_epi64(r, 31));
+                r = _mm512_mask_sub_epi64(r, _mm512_cmpge_epu64_mask(r, m), r, m);
+                __m512i thr  = _mm512_cvtepu32_epi64(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(thresholds + k*count + i)));
+                __mmask8 below = _mm512_cmplt_epu64_mask(r, thr);
+                for (int lane = 0; lane < 8; ++lane)
+                    mask[lane] |= unsigned((below >> lane) & 1) << k;
+            }
+            for (int lane = 0; lane < 8; ++lane)
+                masks[i + lane] = std::uint8_t(mask[lane]);
+        }
+        scalar_tail(cells, thresholds, count, i, time_step, masks);
+    }
+#pragma GCC diagnostic pop
+#endif
+    // ----------------------------------------------------------------------------------------------------------------
+    struct Selection
+    {
+        front_kernel::Kernel kernel;
+        char const*          name;
+    };
+
+    Selection detect()
+    {
+#if defined(__x86_64__)
+        // Les versions vectorielles supposent un std::uint_fast32_t sur 64 bits (cas de Linux x86-64) :
+        // pseudo_random travaille alors modulo 2^64.
+        if (sizeof(std::uint_fast32_t) != 8)
+            return { scalar_kernel, "scalar" };
+        __builtin_cpu_init();
+        bool has_avx512 = __builtin_cpu_supports("avx512f");
+        bool has_avx2   = __builtin_cpu_supports("avx2");
+        bool has_sse42  = __builtin_cpu_supports("sse4.2");
+
+        char const* forced = std::getenv("FIRE_KERNEL");
+        if (forced != nullptr)
+        {
+            if ( (forced == "avx512"s) && has_avx512 ) return { avx512_kernel, "avx512" };
+            if ( (forced == "avx2"s)   && has_avx2   ) return { avx2_kernel,   "avx2"   };
+            if ( (forced == "sse4.2"s) && has_sse42  ) return { sse42_kernel,  "sse4.2" };
+            if (  forced == "scalar"s                ) return { scalar_kernel, "scalar" };
+        }
+        if (has_avx512) return { avx512_kernel, "avx512" };
+        if (has_avx2  ) return { avx2_kernel,   "avx2"   };
+        if (has_sse42 ) return { sse42_kernel,  "sse4.2" };
+#endif
+        return { scalar_kernel, "scalar" };
+    }
+
+    Selection const& selection()
+    {
+        static const Selection unique_selection = detect();
+        return unique_selection;
+    }
+}
+// ====================================================================================================================
+front_kernel::Kernel
+front_kernel::select()
+{
+    return selection().kernel;
+}
+// --------------------------------------------------------------------------------------------------------------------
+char const*
+front_kernel::name()
+{
+    return selection().name;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Noyau de tirage pour un lot de cases du front de feu.
+ *
+ * Pour chaque case f du lot, calcule les cinq tirages bruts du modèle (les quatre voisins puis
+ * l'affaiblissement du foyer, germes f*m_k + pas de temps) et les compare aux seuils entiers fournis.
+ * Le résultat est un masque par case : le bit k vaut 1 si le tirage k est sous son seuil.
+ * Les seuils sont rangés par tirage : seuil k de la case i en thresholds[k*count + i].
+ *
+ * L'implémentation (scalaire, SSE4.2, AVX2 ou AVX-512) est choisie une seule fois, à l'exécution, selon
+ * le processeur. La variable d'environnement FIRE_KERNEL (scalar, sse4.2, avx2, avx512) permet d'en imposer
+ * une parmi celles supportées.
+ */
+namespace front_kernel
+{
+    constexpr std::size_t nb_draws   = 5;   // Quatre voisins + affaiblissement du foyer
+    constexpr std::size_t batch_size = 256; // Nombre de cases traitées par appel
+
+    using Kernel = void (*)( std::uint32_t const * cells, std::uint32_t const * thresholds, std::size_t count,
+                             std::size_t time_step, std::uint8_t * masks );
+
+    Kernel      select();
+    char const* name  ();
+}
@@ -0,0 +1,97 @@
+#include <stdexcept>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <openssl/sha.h> // Pour SHA-1
+#include "model.hpp"
+#include "verifier.hpp"
+
+Verifier::Verifier(Cadence t_cadence, std::size_t t_period, Method t_method)
+    : m_cadence(t_cadence),
+      m_period(t_period),
+      m_method(t_method)
+{
+    if ((m_cadence == Periodic) && (m_period == 0))
+        throw std::range_error("La période des empreintes doit être plus grande que zéro.");
+    if ((m_cadence != Off) && (m_method == Sha1))
+        m_worker = std::thread(&Verifier::run, this);
+}
+// --------------------------------------------------------------------------------------------------------------------
+Verifier::~Verifier()
+{
+    if (!m_worker.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_changed.notify_all();
+    m_worker.join();
+}
+// --------------------------------------------------------------------------------------------------------------------
+void Verifier::after_step(Model const& t_model)
+{
+    if ((m_cadence == Periodic) && (t_model.time_step() % m_period == 0))
+        push(t_model);
+}
+// --------------------------------------------------------------------------------------------------------------------
+void Verifier::finish(Model const& t_model)
+{
+    if (m_cadence == Off)
+        return;
+    if ((m_cadence == FinalOnly) || (t_model.time_step() % m_period == 0))
+        if (m_last_time_step != t_model.time_step())
+            push(t_model);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.wait(lock, [this]() { return m_pending.empty(); });
+}
+// --------------------------------------------------------------------------------------------------------------------
+void Verifier::push(Model const& t_model)
+{
+    if (m_method == Incremental)
+    {
+        char digest[17];
+        std::snprintf(digest, sizeof(digest), "%016llx", static_cast<unsigned long long>(t_model.digest()));
+        std::cout << "Empreinte à t=" << t_model.time_step() << ": " << digest << std::endl;
+        m_last_time_step = t_model.time_step();
+        return;
+    }
+    // La copie est faite ici, par le thread de la simulation : le thread de fond ne lit jamais le modèle.
+    MapSnapshot snapshot = t_model.snapshot();
+    m_last_time_step = snapshot.time_step();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.wait(lock, [this]() { return m_pending.size() < max_pending; });
+    m_pending.push_back(std::move(snapshot));
+    lock.unlock();
+    m_changed.notify_all();
+}
+// --------------------------------------------------------------------------------------------------------------------
+void Verifier::run()
+{
+    static const char digits[] = "0123456789abcdef";
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_changed.wait(lock, [this]() { return m_stop || !m_pending.empty(); });
+        if (m_pending.empty())
+            return;
+        MapSnapshot const& snapshot = m_pending.front();
+        lock.unlock();
+
+        unsigned char hash[SHA_DIGEST_LENGTH];
+        SHA1(snapshot.bytes(), snapshot.size(), hash);
+        std::string line = "SHA-1 à t=" + std::to_string(snapshot.time_step()) + ": ";
+        for (unsigned char byte : hash)
+        {
+            line += digits[byte >> 4];
+            line += digits[byte & 15];
+        }
+        // Une seule écriture par ligne : pas de mélange avec les affichages de la simulation
+        std::cout << line + "\n" << std::flush;
+
+        lock.lock();
+        m_pending.pop_front();
+        m_changed.notify_all();
+    }
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+
+/**
+ * @brief Ensemble des cases en feu avec l'intensité du foyer associée.
+ *
+ * Les cases actives sont rangées de façon contiguë (indice dans la carte, position dans les cartes stockées avec
+ * leur bordure et intensité) et une table de la taille de la carte donne la place de chaque case dans ce tableau
+ * dense. La table n'a jamais besoin
+ * d'être remise à zéro : une case appartient au front si sa position est valide et pointe bien sur elle.
+ * Insertion, suppression, recherche et vidage se font en O(1), le parcours est contigu et toute la
+ * mémoire est réservée à la construction (aucune allocation pendant la simulation).
+ * sort() range le tableau dense par clés croissantes ; ses tampons ne sont réservés que par reserve_sort(), un front
+ * jamais trié n'en paie pas la mémoire.
+ */
+class FireFront
+{
+public:
+    explicit FireFront( std::size_t t_nb_cells )
+        :   m_slots(t_nb_cells, 0u)
+    {
+        m_cells.reserve(t_nb_cells);
+        m_positions.reserve(t_nb_cells);
+        m_intensities.reserve(t_nb_cells);
+    }
+
+    std::size_t size () const { return m_cells.size(); }
+    bool        empty() const { return m_cells.empty(); }
+
+    // Accès à la i-ème case du tableau dense :
+    std::size_t  index    ( std::size_t i ) const { return m_cells[i]; }
+    std::uint32_t position( std::size_t i ) const { return m_positions[i]; }
+    std::uint8_t intensity( std::size_t i ) const { return m_intensities[i]; }
+    std::uint32_t const * cells() const { return m_cells.data(); }
+
+    bool contains( std::size_t t_index ) const
+    {
+        std::uint32_t slot = m_slots[t_index];
+        return (slot < m_cells.size()) && (m_cells[slot] == t_index);
+    }
+
+    // Insère la case ou met à jour l'intensité si elle est déjà dans le front
+    void set( std::size_t t_index, std::size_t t_position, std::uint8_t t_intensity )
+    {
+        if (contains(t_index))
+        {
+            m_intensities[m_slots[t_index]] = t_intensity;
+            return;
+        }
+        m_slots[t_index] = std::uint32_t(m_cells.size());
+        m_cells.push_back(std::uint32_t(t_index));
+        m_positions.push_back(std::uint32_t(t_position));
+        m_intensities.push_back(t_intensity);
+    }
+
+    // Retire la case en la remplaçant par la dernière du tableau dense
+    void erase( std::size_t t_index )
+    {
+        if (!contains(t_index)) return;
+        std::uint32_t slot = m_slots[t_index];
+        m_cells[slot]       = m_cells.back();
+        m_positions[slot]   = m_positions.back();
+        m_intensities[slot] = m_intensities.back();
+        m_slots[m_cells[slot]] = slot;
+        m_cells.pop_back();
+        m_positions.pop_back();
+        m_intensities.pop_back();
+    }
+
+    void clear()
+    {
+        m_cells.clear();
+        m_positions.clear();
+        m_intensities.clear();
+    }
+
+    // Échange du contenu avec t_other (double tampon : aucune copie ni allocation)
+    void swap( FireFront & t_other ) noexcept
+    {
+        m_slots.swap(t_other.m_slots);
+        m_cells.swap(t_other.m_cells);
+        m_positions.swap(t_other.m_positions);
+        m_intensities.swap(t_other.m_intensities);
+    }
+
+    // Réserve les tampons de sort() pour un front couvrant toute la carte : sort() n'alloue alors plus rien
+    void reserve_sort()
+    {
+        m_keys.reserve(m_slots.size());
+        m_order.reserve(m_slots.size());
+        m_sorted_keys.reserve(m_slots.size());
+        m_sorted_order.reserve(m_slots.size());
+        m_sorted_intensities.reserve(m_slots.size());
+    }
+
+    // Range les cases par clé croissante, t_key(indice) donnant la clé de chaque case sur t_nb_bits bits.
+    // Tri par base stable (octet par octet, les octets communs à toutes les clés sont sautés), en O(taille).
+    template<typename Key>
+    void sort( unsigned t_nb_bits, Key && t_key )
+    {
+        std::size_t n = m_cells.size();
+        if (n == 0) return;
+        m_keys.resize(n);
+        m_order.resize(n);
+        m_sorted_keys.resize(n);
+        m_sorted_order.resize(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            m_keys[i]  = t_key(m_cells[i]);
+            m_order[i] = std::uint32_t(i);
+        }
+        for (unsigned shift = 0; shift < t_nb_bits; shift += 8)
+        {
+            std::array<std::size_t, 256> counts{};
+            for (std::size_t i = 0; i < n; ++i)
+                ++counts[(m_keys[i] >> shift) & 0xFFu];
+            if (counts[(m_keys[0] >> shift) & 0xFFu] == n)
+                continue;
+            std::size_t offset = 0;
+            for (std::size_t & count : counts)
+            {
+                std::size_t c = count;
+                count   = offset;
+                offset += c;
+            }
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                std::size_t place = counts[(m_keys[i] >> shift) & 0xFFu]++;
+                m_sorted_keys[place]  = m_keys[i];
+                m_sorted_order[place] = m_order[i];
+            }
+            m_keys.swap(m_sorted_keys);
+            m_order.swap(m_sorted_order);
+        }
+        // Permutation des trois tableaux, m_sorted_keys servant de tampon aux positions et m_sorted_order aux cases
+        m_sorted_keys.resize(n);
+        m_sorted_order.resize(n);
+        m_sorted_intensities.resize(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            std::uint32_t from = m_order[i];
+            m_sorted_order[i]       = m_cells[from];
+            m_sorted_keys[i]        = m_positions[from];
+            m_sorted_intensities[i] = m_intensities[from];
+            m_slots[m_cells[from]]  = std::uint32_t(i);
+        }
+        std::copy(m_sorted_order.begin(), m_sorted_order.begin() + n, m_cells.begin());
+        std::copy(m_sorted_keys.begin(), m_sorted_keys.begin() + n, m_positions.begin());
+        std::copy(m_sorted_intensities.begin(), m_sorted_intensities.begin() + n, m_intensities.begin());
+    }
+
+private:
+    std::vector<std::uint32_t> m_slots;       // Position de chaque case de la carte dans le tableau dense
+    std::vector<std::uint32_t> m_cells;       // Indices des cases en feu
+    std::vector<std::uint32_t> m_positions;   // Leur position dans les cartes stockées avec bordure
+    std::vector<std::uint8_t>  m_intensities; // Intensité du feu pour chacune de ces cases
+    // Tampons de sort()
+    std::vector<std::uint32_t> m_keys, m_order, m_sorted_keys, m_sorted_order;
+    std::vector<std::uint8_t>  m_sorted_intensities;
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "dirty_tiles.hpp"
+#include "map_view.hpp"
+
+/**
+ * @brief Image ARGB (8 bits par canal) des cartes de feu et de végétation, gardée d'une image à l'autre.
+ *
+ * La couleur d'une case est lue dans une palette précalculée : palette du feu (rouge et opacité) selon l'intensité,
+ * OU binaire avec la palette de la végétation (vert) selon la végétation restante. La ligne 0 des cartes est la
+ * ligne du bas de l'image. La conversion est répartie entre les threads par lignes ; chaque ligne passe par un
+ * noyau choisi une fois selon le processeur (lecture vectorielle de la palette en AVX2, ou scalaire).
+ * Le tampon est prêt à être envoyé tel quel dans une texture SDL_PIXELFORMAT_ARGB8888.
+ */
+class Frame
+{
+public:
+    struct Palette
+    {
+        std::array<std::uint32_t, 256> fire, vegetation;
+    };
+
+    Frame( unsigned t_width, unsigned t_height );
+
+    unsigned width () const { return m_width;  }
+    unsigned height() const { return m_height; }
+    std::uint32_t const * pixels() const { return m_pixels.data(); }
+    std::size_t pitch() const { return m_width * sizeof(std::uint32_t); } // Octets par ligne de l'image
+
+    // Recalcule toute l'image (cases hors de l'image ignorées)
+    void render( MapView const & t_vegetation, MapView const & t_fire );
+    // Recalcule seulement les pixels des tuiles modifiées
+    void render( MapView const & t_vegetation, MapView const & t_fire, DirtyTiles const & t_tiles );
+
+    static Palette const & palette();
+    static char const *    kernel_name();
+
+private:
+    unsigned m_width, m_height;
+    std::vector<std::uint32_t> m_pixels;
+};
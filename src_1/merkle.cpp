@@ -0,0 +1,126 @@
+#include <stdexcept>
+#include <algorithm>
+#include <cstdio>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include "state_digest.hpp"
+#include "merkle.hpp"
+
+unsigned merkle::tiles_per_side(unsigned t_geometry)
+{
+    return (t_geometry + tile_size - 1) / tile_size;
+}
+// --------------------------------------------------------------------------------------------------------------------
+void merkle::accumulate_leaves(MapView const& t_fire, MapView const& t_vegetation, unsigned t_geometry,
+                               unsigned t_first_row, std::vector<std::uint64_t>& t_leaves)
+{
+    unsigned nb_rows  = t_fire.rows();
+    unsigned nb_tiles = tiles_per_side(t_geometry);
+    if (t_leaves.size() != std::size_t(nb_tiles) * nb_tiles)
+        throw std::logic_error("Nombre de feuilles incohérent avec la taille de la carte.");
+    if (nb_rows == 0)
+        return;
+    // Chaque thread traite des lignes de tuiles entières : aucune feuille n'est écrite par deux threads
+    int first_tile_row = int(t_first_row / tile_size);
+    int last_tile_row  = int((t_first_row + nb_rows - 1) / tile_size);
+    #pragma omp parallel for schedule(dynamic)
+    for (int tile_row = first_tile_row; tile_row <= last_tile_row; ++tile_row)
+    {
+        unsigned row_begin = std::max(unsigned(tile_row) * tile_size, t_first_row);
+        unsigned row_end   = std::min((unsigned(tile_row) + 1) * tile_size, t_first_row + nb_rows);
+        for (unsigned row = row_begin; row < row_end; ++row)
+        {
+            unsigned    local = row - t_first_row;
+            std::size_t index = std::size_t(row) * t_geometry;
+            for (unsigned column = 0; column < t_geometry; ++column)
+                t_leaves[std::size_t(tile_row) * nb_tiles + column / tile_size] +=
+                    state_digest::key(state_digest::Fire, index + column, t_fire(local, column)) +
+                    state_digest::key(state_digest::Vegetation, index + column, t_vegetation(local, column));
+        }
+    }
+}
+// --------------------------------------------------------------------------------------------------------------------
+std::uint64_t merkle::combine(std::uint64_t t_left, std::uint64_t t_right)
+{
+    // Mélange de splitmix64 sur le fils gauche, puis sur le résultat combiné au fils droit : l'ordre compte
+    auto mix = [](std::uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    };
+    return mix(mix(t_left) ^ t_right);
+}
+// --------------------------------------------------------------------------------------------------------------------
+std::vector<std::vector<std::uint64_t>> merkle::build_tree(std::vector<std::uint64_t> const& t_leaves)
+{
+    std::vector<std::vector<std::uint64_t>> levels{t_leaves};
+    while (levels.back().size() > 1)
+    {
+        std::vector<std::uint64_t> const& children = levels.back();
+        std::vector<std::uint64_t> parents((children.size() + 1) / 2);
+        for (std::size_t i = 0; i < parents.size(); ++i)
+            parents[i] = (2 * i + 1 < children.size()) ? combine(children[2 * i], children[2 * i + 1])
+                                                       : children[2 * i];
+        levels.push_back(std::move(parents));
+    }
+    return levels;
+}
+// --------------------------------------------------------------------------------------------------------------------
+void merkle::write_step(std::ostream& t_out, std::size_t t_time_step, unsigned t_geometry,
+                        std::vector<std::uint64_t> const& t_leaves)
+{
+    auto tree = build_tree(t_leaves);
+    std::string line = std::to_string(t_time_step) + " " + std::to_string(t_geometry);
+    char hexa[18];
+    std::snprintf(hexa, sizeof(hexa), " %016llx", static_cast<unsigned long long>(tree.back().front()));
+    line += hexa;
+    for (std::uint64_t leaf : t_leaves)
+    {
+        std::snprintf(hexa, sizeof(hexa), " %016llx", static_cast<unsigned long long>(leaf));
+        line += hexa;
+    }
+    t_out << line << '\n';
+}
+// --------------------------------------------------------------------------------------------------------------------
+bool merkle::read_step(std::istream& t_in, Step& t_step)
+{
+    std::string line;
+    if (!std::getline(t_in, line))
+        return false;
+    std::istringstream fields(line);
+    fields >> t_step.time_step >> t_step.geometry >> std::hex >> t_step.root;
+    if (!fields)
+        throw std::runtime_error("Ligne de journal de Merkle mal formée : " + line.substr(0, 40));
+    unsigned nb_tiles = tiles_per_side(t_step.geometry);
+    t_step.leaves.resize(std::size_t(nb_tiles) * nb_tiles);
+    for (std::uint64_t& leaf : t_step.leaves)
+        fields >> leaf;
+    if (!fields)
+        throw std::runtime_error("Feuilles manquantes au pas de temps " + std::to_string(t_step.time_step));
+    return true;
+}
+// --------------------------------------------------------------------------------------------------------------------
+std::vector<std::size_t> merkle::diverging_leaves(std::vector<std::vector<std::uint64_t>> const& t_first,
+                                                  std::vector<std::vector<std::uint64_t>> const& t_second)
+{
+    if ((t_first.size() != t_second.size()) || (t_first.front().size() != t_second.front().size()))
+        throw std::logic_error("Arbres de Merkle de tailles différentes.");
+    // Nœuds différents du niveau courant, en partant de la racine
+    std::vector<std::size_t> nodes;
+    if (t_first.back().front() != t_second.back().front())
+        nodes.push_back(0);
+    for (std::size_t level = t_first.size() - 1; level > 0; --level)
+    {
+        std::vector<std::size_t> children;
+        for (std::size_t node : nodes)
+            for (std::size_t child = 2 * node; child < std::min(2 * node + 2, t_first[level - 1].size()); ++child)
+                if (t_first[level - 1][child] != t_second[level - 1][child])
+                    children.push_back(child);
+        nodes.swap(children);
+    }
+    return nodes;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+#include "map_view.hpp"
+
+/**
+ * @brief Arbre de Merkle sur les tuiles des cartes de feu et de végétation.
+ *
+ * La carte est découpée en tuiles de tile_size x tile_size cases. La feuille d'une tuile est l'empreinte
+ * incrémentale (state_digest.hpp) restreinte à ses cases : une somme, que chaque thread ou processus peut calculer
+ * sur ses propres lignes avant d'additionner les contributions (MPI_SUM). La somme de toutes les feuilles est donc
+ * Model::digest(). Les nœuds internes combinent leurs deux fils dans l'ordre ; la racine résume tout l'état.
+ *
+ * Le journal contient une ligne par pas de temps : pas, nombre de cases par direction, racine puis feuilles (ligne
+ * par ligne, en hexadécimal). merkle_diff compare deux journaux et localise les tuiles où les simulations divergent.
+ */
+namespace merkle
+{
+    constexpr unsigned tile_size = 64;
+
+    unsigned tiles_per_side( unsigned t_geometry );
+
+    // Ajoute aux feuilles (tiles_per_side² valeurs) l'empreinte des lignes [t_first_row, t_first_row + rows())
+    // de la carte, lues dans les vues t_fire et t_vegetation (leur ligne 0 est la ligne t_first_row).
+    void accumulate_leaves( MapView const & t_fire, MapView const & t_vegetation, unsigned t_geometry,
+                            unsigned t_first_row, std::vector<std::uint64_t> & t_leaves );
+
+    std::uint64_t combine( std::uint64_t t_left, std::uint64_t t_right );
+    // Niveaux de l'arbre, des feuilles (niveau 0) à la racine (dernier niveau, une seule valeur). Un nœud sans
+    // frère remonte tel quel.
+    std::vector<std::vector<std::uint64_t>> build_tree( std::vector<std::uint64_t> const & t_leaves );
+
+    struct Step
+    {
+        std::size_t                time_step;
+        unsigned                   geometry;
+        std::uint64_t              root;
+        std::vector<std::uint64_t> leaves;
+    };
+
+    void write_step( std::ostream & t_out, std::size_t t_time_step, unsigned t_geometry,
+                     std::vector<std::uint64_t> const & t_leaves );
+    // Lit la ligne suivante du journal ; faux en fin de fichier. Lève std::runtime_error si la ligne est mal formée.
+    bool read_step( std::istream & t_in, Step & t_step );
+
+    // Indices des feuilles qui diffèrent, trouvées en descendant depuis la racine dans les seuls sous-arbres dont
+    // les nœuds diffèrent.
+    std::vector<std::size_t> diverging_leaves( std::vector<std::vector<std::uint64_t>> const & t_first,
+                                               std::vector<std::vector<std::uint64_t>> const & t_second );
+}
@@ -0,0 +1,75 @@
+#include <stdexcept>
+#include <algorithm>
+#include <string>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include "merkle.hpp"
+
+// Compare deux journaux de Merkle (option --merkle de la simulation) et indique le premier pas de temps où les
+// simulations divergent, avec les tuiles concernées.
+int main( int nargs, char* args[] )
+{
+    if (nargs != 3)
+    {
+        std::cerr << "Usage : merkle_diff JOURNAL_1 JOURNAL_2" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::ifstream first(args[1]), second(args[2]);
+    if (!first || !second)
+    {
+        std::cerr << "Impossible d'ouvrir " << (first ? args[2] : args[1]) << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    merkle::Step step_1, step_2;
+    std::size_t nb_steps = 0;
+    try
+    {
+        while (true)
+        {
+            bool more_1 = merkle::read_step(first, step_1), more_2 = merkle::read_step(second, step_2);
+            if (!more_1 && !more_2)
+                break;
+            if (more_1 != more_2)
+            {
+                std::cout << "Le journal " << (more_1 ? args[2] : args[1]) << " s'arrête après " << nb_steps
+                          << " pas de temps, identiques à ceux de l'autre journal." << std::endl;
+                return EXIT_FAILURE;
+            }
+            if ((step_1.time_step != step_2.time_step) || (step_1.geometry != step_2.geometry))
+            {
+                std::cout << "Journaux incompatibles à la ligne " << nb_steps + 1 << " (pas " << step_1.time_step
+                          << " / " << step_2.time_step << ", " << step_1.geometry << " / " << step_2.geometry
+                          << " cases par direction)." << std::endl;
+                return EXIT_FAILURE;
+            }
+            ++nb_steps;
+            if (step_1.root == step_2.root)
+                continue;
+
+            auto tiles = merkle::diverging_leaves(merkle::build_tree(step_1.leaves),
+                                                  merkle::build_tree(step_2.leaves));
+            std::cout << "Divergence au pas de temps " << step_1.time_step << " sur " << tiles.size()
+                      << " tuile(s) de " << merkle::tile_size << "x" << merkle::tile_size << " cases :" << std::endl;
+            unsigned nb_tiles = merkle::tiles_per_side(step_1.geometry);
+            for (std::size_t tile : tiles)
+            {
+                std::size_t row = tile / nb_tiles, column = tile % nb_tiles;
+                std::size_t last_row    = std::min((row + 1) * merkle::tile_size, std::size_t(step_1.geometry)) - 1;
+                std::size_t last_column = std::min((column + 1) * merkle::tile_size, std::size_t(step_1.geometry)) - 1;
+                std::cout << "\ttuile (ligne " << row << ", colonne " << column << ") : lignes "
+                          << row * merkle::tile_size << " à " << last_row << ", colonnes "
+                          << column * merkle::tile_size << " à " << last_column << std::endl;
+            }
+            return EXIT_FAILURE;
+        }
+    }
+    catch (std::exception const& error)
+    {
+        std::cerr << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "Aucune divergence sur " << nb_steps << " pas de temps." << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -1,218 +1,745 @@
-#include "model.hpp"
-
-namespace
-{
-    double pseudo_random(std::size_t index, std::size_t time_step)
-    {
-        std::uint_fast32_t xi = std::uint_fast32_t(index * (time_step + 1));
-        std::uint_fast32_t r = (48271 * xi) % 2147483647;
-        return r / 2147483646.;
-    }
-
-    double log_factor(std::uint8_t value)
-    {
-        return std::log(1. + value) / std::log(256);
-    }
-}
-
-Model::Model(double t_length, unsigned t_discretization, std::array<double, 2> t_wind,
-             LexicoIndices t_start_fire_position, double t_max_wind)
-    : m_length(t_length),
-      m_distance(-1),
-      m_geometry(t_discretization),
-      m_wind(t_wind),
-      m_wind_speed(std::sqrt(t_wind[0] * t_wind[0] + t_wind[1] * t_wind[1])),
-      m_max_wind(t_max_wind),
-      m_vegetation_map(t_discretization * t_discretization, 255u),
-      m_fire_map(t_discretization * t_discretization, 0u)
-{
-    if (t_discretization == 0)
-    {
-        throw std::range_error("Le nombre de cases par direction doit être plus grand que zéro.");
-    }
-    m_distance = m_length / double(m_geometry);
-    auto index = get_index_from_lexicographic_indices(t_start_fire_position);
-    m_fire_map[index] = 255u;
-    m_fire_front[index] = 255u;
-
-    constexpr double alpha0 = 4.52790762e-01;
-    constexpr double alpha1 = 9.58264437e-04;
-    constexpr double alpha2 = 3.61499382e-05;
-
-    if (m_wind_speed < t_max_wind)
-        p1 = alpha0 + alpha1 * m_wind_speed + alpha2 * (m_wind_speed * m_wind_speed);
-    else
-        p1 = alpha0 + alpha1 * t_max_wind + alpha2 * (t_max_wind * t_max_wind);
-    p2 = 0.3;
-
-    if (m_wind[0] > 0)
-    {
-        alphaEastWest = std::abs(m_wind[0] / t_max_wind) + 1;
-        alphaWestEast = 1. - std::abs(m_wind[0] / t_max_wind);
-    }
-    else
-    {
-        alphaWestEast = std::abs(m_wind[0] / t_max_wind) + 1;
-        alphaEastWest = 1. - std::abs(m_wind[0] / t_max_wind);
-    }
-
-    if (m_wind[1] > 0)
-    {
-        alphaSouthNorth = std::abs(m_wind[1] / t_max_wind) + 1;
-        alphaNorthSouth = 1. - std::abs(m_wind[1] / t_max_wind);
-    }
-    else
-    {
-        alphaNorthSouth = std::abs(m_wind[1] / t_max_wind) + 1;
-        alphaSouthNorth = 1. - std::abs(m_wind[1] / t_max_wind);
-    }
-}
-// --------------------------------------------------------------------------------------------------------------------
-bool Model::update()
-{
-    std::vector<std::size_t> fire_keys;
-    for (const auto& pair : m_fire_front) {
-        fire_keys.push_back(pair.first);
-    }
-
-    auto next_front = m_fire_front;
-
-    #pragma omp parallel for  
-    for (size_t i = 0; i < fire_keys.size(); ++i)
-    {
-        std::size_t f = fire_keys[i];
-        LexicoIndices coord = get_lexicographic_from_index(f);
-        double power = log_factor(m_fire_front[f]);
-
-        if (coord.row < m_geometry - 1)
-        {
-            double tirage = pseudo_random(f + m_time_step, m_time_step);
-            double green_power = m_vegetation_map[f + m_geometry];
-            double correction = power * log_factor(green_power);
-            if (tirage < alphaSouthNorth * p1 * correction)
-            {
-                #pragma omp critical
-                {
-                    m_fire_map[f + m_geometry] = 255;
-                    next_front[f + m_geometry] = 255;
-                }
-            }
-        }
-
-        if (coord.row > 0)
-        {
-            double tirage = pseudo_random(f * 13427 + m_time_step, m_time_step);
-            double green_power = m_vegetation_map[f - m_geometry];
-            double correction = power * log_factor(green_power);
-            if (tirage < alphaNorthSouth * p1 * correction)
-            {
-                #pragma omp critical
-                {
-                    m_fire_map[f - m_geometry] = 255;
-                    next_front[f - m_geometry] = 255;
-                }
-            }
-        }
-
-        if (coord.column < m_geometry - 1)
-        {
-            double tirage = pseudo_random(f * 13427 * 13427 + m_time_step, m_time_step);
-            double green_power = m_vegetation_map[f + 1];
-            double correction = power * log_factor(green_power);
-            if (tirage < alphaEastWest * p1 * correction)
-            {
-                #pragma omp critical
-                {
-                    m_fire_map[f + 1] = 255;
-                    next_front[f + 1] = 255;
-                }
-            }
-        }
-
-        if (coord.column > 0)
-        {
-            double tirage = pseudo_random(f * 13427 * 13427 * 13427 + m_time_step, m_time_step);
-            double green_power = m_vegetation_map[f - 1];
-            double correction = power * log_factor(green_power);
-            if (tirage < alphaWestEast * p1 * correction)
-            {
-                #pragma omp critical
-                {
-                    m_fire_map[f - 1] = 255;
-                    next_front[f - 1] = 255;
-                }
-            }
-        }
-
-        if (m_fire_front[f] == 255)
-        {
-            double tirage = pseudo_random(f * 52513 + m_time_step, m_time_step);
-            if (tirage < p2)
-            {
-                #pragma omp critical
-                {
-                    m_fire_map[f] >>= 1;
-                    next_front[f] >>= 1;
-                }
-            }
-        }
-        else
-        {
-            #pragma omp critical
-            {
-                m_fire_map[f] >>= 1;
-                next_front[f] >>= 1;
-                if (next_front[f] == 0)
-                {
-                    next_front.erase(f);
-                }
-            }
-        }
-    }
-
-    m_fire_front = next_front;
-    for (auto f : m_fire_front)
-    {
-        if (m_vegetation_map[f.first] > 0)
-            m_vegetation_map[f.first] -= 1;
-    }
-    m_time_step += 1;
-
-    // Ajout du calcul SHA-1 pour m_fire_map et m_vegetation_map
-    std::stringstream buffer;
-    // Parcours de m_fire_map (std::vector<uint8_t>, ordre des indices)
-    for (const auto& val : m_fire_map) {
-        buffer << static_cast<int>(val); // Convertit uint8_t en int pour éviter problèmes d’affichage
-    }
-    // Parcours de m_vegetation_map (std::vector<uint8_t>, ordre des indices)
-    for (const auto& val : m_vegetation_map) {
-        buffer << static_cast<int>(val); // Idem
-    }
-    std::string data = buffer.str();
-
-    // Calcul du hash SHA-1
-    unsigned char hash[SHA_DIGEST_LENGTH];
-    SHA1(reinterpret_cast<const unsigned char*>(data.c_str()), data.size(), hash);
-
-    // Conversion en hexadécimal pour affichage
-    std::stringstream ss;
-    for (int i = 0; i < SHA_DIGEST_LENGTH; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
-    }
-    std::cout << "SHA-1 à t=" << m_time_step << ": " << ss.str() << std::endl;
-
-    return !m_fire_front.empty();
-}
-// ====================================================================================================================
-std::size_t Model::get_index_from_lexicographic_indices(LexicoIndices t_lexico_indices) const
-{
-    return t_lexico_indices.row * this->geometry() + t_lexico_indices.column;
-}
-// --------------------------------------------------------------------------------------------------------------------
-auto Model::get_lexicographic_from_index(std::size_t t_global_index) const -> LexicoIndices
-{
-    LexicoIndices ind_coords;
-    ind_coords.row = t_global_index / this->geometry();
-    ind_coords.column = t_global_index % this->geometry();
-    return ind_coords;
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <omp.h>
+#include "model.hpp"
+
+namespace
+{
+    constexpr std::size_t   weakening = 4;           // Indice du tirage d'affaiblissement du foyer dans le noyau
+    constexpr std::uint32_t always    = 2147483647u; // Seuil au-dessus de tout tirage brut
+
+    std::uint_fast32_t pseudo_random_raw(std::size_t index, std::size_t time_step)
+    {
+        std::uint_fast32_t xi = std::uint_fast32_t(index * (time_step + 1));
+        return (48271 * xi) % 2147483647;
+    }
+
+    [[maybe_unused]] double pseudo_random(std::size_t index, std::size_t time_step)
+    {
+        return pseudo_random_raw(index, time_step) / 2147483646.;
+    }
+
+
+    double log_factor(std::uint8_t value)
+    {
+        return std::log(1. + value) / std::log(256);
+    }
+
+    // Plus petit tirage brut r tel que r/2147483646. >= probability : le test flottant
+    // "pseudo_random(...) < probability" est alors exactement "pseudo_random_raw(...) < seuil".
+    std::uint32_t raw_threshold(double probability)
+    {
+        if (!(probability > 0.))
+            return 0u;
+        if (probability > 1.)
+            return 2147483647u;
+        std::uint64_t r = std::uint64_t(probability * 2147483646.);
+        while ((r > 0) && ((r - 1) / 2147483646. >= probability))
+            --r;
+        while ((r <= 2147483646u) && (r / 2147483646. < probability))
+            ++r;
+        return std::uint32_t(r);
+    }
+}
+
+Model::Model(double t_length, unsigned t_discretization, std::array<double, 2> t_wind,
+             LexicoIndices t_start_fire_position, double t_max_wind)
+    : m_length(t_length),
+      m_distance(-1),
+      m_geometry(t_discretization),
+      m_stride(unsigned(stored_stride(t_discretization))),
+      m_wind(t_wind),
+      m_wind_speed(std::sqrt(t_wind[0] * t_wind[0] + t_wind[1] * t_wind[1])),
+      m_max_wind(t_max_wind),
+      m_vegetation_map(stored_cells(t_discretization), 0u),
+      m_fire_map(stored_cells(t_discretization)),
+      m_exhausted_neighbours(stored_cells(t_discretization), 0u),
+      m_fire_front(t_discretization * t_discretization),
+      m_next_front(t_discretization * t_discretization),
+      m_decay_wheel(t_discretization * t_discretization),
+      m_kernel(front_kernel::select()),
+      m_front_masks(t_discretization * t_discretization, 0u),
+      m_fire_buffer(stored_cells(t_discretization)),
+      m_tiles_per_side((t_discretization + tile_size - 1) / tile_size),
+      m_active_tiles(std::size_t(m_tiles_per_side) * m_tiles_per_side, 0u),
+      m_next_active_tiles(std::size_t(m_tiles_per_side) * m_tiles_per_side, 0u),
+      m_changed_tiles(t_discretization, t_discretization, tile_size)
+{
+    if (t_discretization == 0)
+    {
+        throw std::range_error("Le nombre de cases par direction doit être plus grand que zéro.");
+    }
+    m_distance = m_length / double(m_geometry);
+    // Végétation à 255 partout sauf sur la bordure (segments de ligne d'une tuile, contigus dans les deux rangements)
+    for (std::size_t row = 0; row < m_geometry; ++row)
+        for (std::size_t column = 0; column < m_geometry; column += tile_size)
+            std::fill_n(m_vegetation_map.begin() + position(row, column),
+                        std::min<std::size_t>(tile_size, m_geometry - column), 255u);
+    // Les cases du bord de la carte ont un voisin sur la bordure
+    for (std::size_t i = 0; i < m_geometry; ++i)
+    {
+        m_exhausted_neighbours[position(0, i)]              |= 1u << NorthSouth;
+        m_exhausted_neighbours[position(m_geometry - 1, i)] |= 1u << SouthNorth;
+        m_exhausted_neighbours[position(i, 0)]              |= 1u << WestEast;
+        m_exhausted_neighbours[position(i, m_geometry - 1)] |= 1u << EastWest;
+    }
+    auto index = get_index_from_lexicographic_indices(t_start_fire_position);
+    auto start = position(t_start_fire_position.row, t_start_fire_position.column);
+    m_fire_map.set(start, 255u);
+    m_fire_front.set(index, start, 255u);
+    m_digest = compute_digest();
+    reserve_thread_buffers();
+
+    constexpr double alpha0 = 4.52790762e-01;
+    constexpr double alpha1 = 9.58264437e-04;
+    constexpr double alpha2 = 3.61499382e-05;
+
+    if (m_wind_speed < t_max_wind)
+        p1 = alpha0 + alpha1 * m_wind_speed + alpha2 * (m_wind_speed * m_wind_speed);
+    else
+        p1 = alpha0 + alpha1 * t_max_wind + alpha2 * (t_max_wind * t_max_wind);
+    p2 = 0.3;
+
+    if (m_wind[0] > 0)
+    {
+        alphaEastWest = std::abs(m_wind[0] / t_max_wind) + 1;
+        alphaWestEast = 1. - std::abs(m_wind[0] / t_max_wind);
+    }
+    else
+    {
+        alphaWestEast = std::abs(m_wind[0] / t_max_wind) + 1;
+        alphaEastWest = 1. - std::abs(m_wind[0] / t_max_wind);
+    }
+
+    if (m_wind[1] > 0)
+    {
+        alphaSouthNorth = std::abs(m_wind[1] / t_max_wind) + 1;
+        alphaNorthSouth = 1. - std::abs(m_wind[1] / t_max_wind);
+    }
+    else
+    {
+        alphaNorthSouth = std::abs(m_wind[1] / t_max_wind) + 1;
+        alphaSouthNorth = 1. - std::abs(m_wind[1] / t_max_wind);
+    }
+
+    // Tables des seuils entiers pour le test d'allumage et l'affaiblissement des foyers
+    m_ignition_thresholds.resize(4 * 256 * 256);
+    for (Direction direction : {SouthNorth, NorthSouth, EastWest, WestEast})
+        for (unsigned power = 0; power < 256; ++power)
+            for (unsigned green_power = 0; green_power < 256; ++green_power)
+            {
+                double correction = log_factor(power) * log_factor(green_power);
+                m_ignition_thresholds[(direction * 256 + power) * 256 + green_power] =
+                    raw_threshold(alpha(direction) * p1 * correction);
+            }
+    m_extinction_threshold = raw_threshold(p2);
+    select_variants();
+}
+// --------------------------------------------------------------------------------------------------------------------
+void Model::select_variants()
+{
+    // Vent nul : les quatre coefficients alpha valent 1 et les tables des quatre directions sont identiques
+    constexpr std::size_t table_size = 256 * 256;
+    bool isotropic = true;
+    for (Direction direction : {NorthSouth, EastWest, WestEast})
+        isotropic = isotropic && std::equal(m_ignition_thresholds.begin(), m_ignition_thresholds.begin() + table_size,
+                                            m_ignition_thresholds.begin() + direction * table_size);
+    m_fill_thresholds = isotropic ? &Model::fill_thresholds<true> : &Model::fill_thresholds<false>;
+
+    bool power_of_two = (m_geometry & (m_geometry - 1)) == 0;
+    while ((1u << m_geometry_shift) < m_geometry)
+        ++m_geometry_shift;
+    m_refresh_tiles = power_of_two ? &Model::refresh_tiles_variant<true> : &Model::refresh_tiles_variant<false>;
+    m_sort_front    = power_of_two ? &Model::sort_front_variant<true>    : &Model::sort_front_variant<false>;
+}
+// --------------------------------------------------------------------------------------------------------------------
+template<bool Isotropic>
+void Model::fill_thresholds(std::size_t t_start, std::uint16_t const* t_drawn, std::size_t t_nb_drawn,
+                            std::uint32_t* t_cells, std::uint32_t* t_thresholds) const
+{
+    // Table de chaque direction ; vent nul : celle de la première pour les quatre voisins
+    constexpr std::size_t table_size = 256 * 256;
+    std::uint32_t const* south_north = m_ignition_thresholds.data() + (Isotropic ? 0 : SouthNorth * table_size);
+    std::uint32_t const* north_south = m_ignition_thresholds.data() + (Isotropic ? 0 : NorthSouth * table_size);
+    std::uint32_t const* east_west   = m_ignition_thresholds.data() + (Isotropic ? 0 : EastWest   * table_size);
+    std::uint32_t const* west_east   = m_ignition_thresholds.data() + (Isotropic ? 0 : WestEast   * table_size);
+    for (std::size_t j = 0; j < t_nb_drawn; ++j)
+    {
+        std::size_t p = m_fire_front.position(t_start + t_drawn[j]);
+        std::uint8_t intensity = m_fire_front.intensity(t_start + t_drawn[j]);
+        std::size_t  row = std::size_t(intensity) * 256;
+        t_cells[j] = m_fire_front.cells()[t_start + t_drawn[j]];
+        // Un voisin sur la bordure n'a pas de végétation : seuil nul, il ne peut pas s'allumer
+        t_thresholds[SouthNorth * t_nb_drawn + j] = south_north[row + m_vegetation_map[south(p)]];
+        t_thresholds[NorthSouth * t_nb_drawn + j] = north_south[row + m_vegetation_map[north(p)]];
+        t_thresholds[EastWest   * t_nb_drawn + j] = east_west  [row + m_vegetation_map[east(p)]];
+        t_thresholds[WestEast   * t_nb_drawn + j] = west_east  [row + m_vegetation_map[west(p)]];
+        // Un foyer qui n'est plus à son max faiblit à coup sûr
+        t_thresholds[weakening * t_nb_drawn + j] = (intensity == 255) ? m_extinction_threshold : always;
+    }
+}
+// --------------------------------------------------------------------------------------------------------------------
+bool Model::update()
+{
+    step(choose_kernel());
+#if defined(VALIDATE_THRESHOLDS)
+    validate_digest();
+#endif
+    return burning_cells() > 0;
+}
+// --------------------------------------------------------------------------------------------------------------------
+bool Model::advance(std::size_t t_nb_steps, std::vector<StepSummary>& t_summaries)
+{
+    // Même évolution que t_nb_steps appels à update(), le parcours de chaque pas étant noté dans son résumé
+    t_summaries.reserve(t_summaries.size() + t_nb_steps);
+    for (std::size_t i = 0; (i < t_nb_steps) && (burning_cells() > 0); ++i)
+    {
+        UpdateKernel kernel = choose_kernel();
+        step(kernel);
+        t_summaries.push_back({m_time_step, burning_cells(), m_burnt_cells, kernel});
+    }
+#if defined(VALIDATE_THRESHOLDS)
+    validate_digest();
+#endif
+    return burning_cells() > 0;
+}
+// --------------------------------------------------------------------------------------------------------------------
+auto Model::choose_kernel() -> UpdateKernel
+{
+    UpdateKernel kernel = m_update_kernel;
+    if ((kernel != Scatter) && !m_tiles_up_to_date)
+        refresh_tiles();
+    if (kernel == Adaptive)
+    {
+        if (m_crossover <= 0.)
+            m_crossover = calibrate_crossover();
+        double area = double(m_nb_active_tiles) * tile_size * tile_size;
+        kernel = (double(burning_cells()) > m_crossover * area) ? Gather : Scatter;
+    }
+    return kernel;
+}
+// --------------------------------------------------------------------------------------------------------------------
+void Model::step(UpdateKernel t_kernel)
+{
+    if (m_track_changes)
+        mark_changed_tiles();
+    if (t_kernel == Gather)
+        gather_step(); // Compte lui-même les cases des blocs parcourus
+    else
+    {
+        m_processed_cells += burning_cells();
+        scatter_step();
+    }
+    sort_front();
+    m_last_kernel = t_kernel;
+    ++m_kernel_steps[t_kernel];
+    m_time_step += 1;
+    if (m_track_changes)
+        mark_changed_tiles();
+}
+// --------------------------------------------------------------------------------------------------------------------
+void Model::mark_changed_tiles()
+{
+    // Tuiles actives : celles où une case est en feu (front ou échéancier d'extinction)
+    if (!m_tiles_up_to_date)
+        refresh_tiles();
+    m_changed_tiles.merge(m_active_tiles);
+}
+// --------------------------------------------------------------------------------------------------------------------
+template<bool PowerOfTwo>
+void Model::sort_front_variant()
+{
+    if (m_front_order == Insertion)
+        return;
+    unsigned nb_bits = 0; // Bits utiles d'un numéro de ligne ou de colonne
+    while ((m_geometry - 1) >> nb_bits)
+        ++nb_bits;
+    if (m_front_order == Rows)
+    {
+        m_fire_front.sort(2 * nb_bits, [](std::uint32_t t_index) { return t_index; });
+        return;
+    }
+    // Bits de t_value placés aux rangs pairs
+    auto spread = [](std::uint32_t t_value)
+    {
+        t_value = (t_value | (t_value << 8)) & 0x00FF00FFu;
+        t_value = (t_value | (t_value << 4)) & 0x0F0F0F0Fu;
+        t_value = (t_value | (t_value << 2)) & 0x33333333u;
+        t_value = (t_value | (t_value << 1)) & 0x55555555u;
+        return t_value;
+    };
+    m_fire_front.sort(2 * nb_bits, [this, &spread](std::uint32_t t_index)
+    {
+        LexicoIndices coord = decode<PowerOfTwo>(t_index);
+        return (spread(coord.row) << 1) | spread(coord.column);
+    });
+}
+// --------------------------------------------------------------------------------------------------------------------
+void Model::reserve_thread_buffers()
+{
+    // Répartition statique des lignes de tuiles dans gather_step : un thread parcourt au plus rows_per_thread lignes
+    // de tuiles, donc n'y trouve pas plus de cases en feu ni de végétations épuisées. Tant que le nombre de threads
+    // ne change pas, les pas de temps n'allouent rien.
+    std::size_t nb_threads = omp_get_max_threads();
+    std::size_t rows_per_thread = (m_tiles_per_side + nb_threads - 1) / nb_threads;
+    std::size_t capacity = std::min(std::size_t(m_geometry), rows_per_thread * tile_size) * m_geometry;
+    m_thread_buffers.resize(nb_threads);
+    for (auto& buffer : m_thread_buffers)
+    {
+        buffer.burning.reserve(capacity);
+        buffer.intensities.reserve(capacity);
+        buffer.exhausted.reserve(capacity);
+    }
+}
+// --------------------------------------------------------------------------------------------------------------------
+void Model::reset_thread_buffers()
+{
+    if (m_thread_buffers.size() < std::size_t(omp_get_max_threads()))
+        reserve_thread_buffers();
+    for (auto& buffer : m_thread_buffers)
+    {
+        buffer.burning.clear();
+        buffer.intensities.clear();
+        buffer.digest = 0;
+        buffer.burnt  = 0;
+        buffer.swept  = 0;
+        buffer.exhausted.clear();
+    }
+}
+// --------------------------------------------------------------------------------------------------------------------
+void Model::scatter_step()
+{
+    // Le front du pas suivant est reconstruit dans le second tampon puis échangé avec le front courant.
+    // Une case allumée par un voisin au cours du pas repart à 255 quel que soit l'ordre de parcours.
+    m_next_front.clear();
+
+    // Phase parallèle : le front est traité par lots (seuils de chaque tirage, tirages et comparaisons dans
+    // le noyau vectoriel) et chaque thread écrit le masque de ses foyers (voisins allumés, affaiblissement) dans
+    // m_front_masks, à la place du foyer dans le front.
+    // Les cartes et le front suivant ne sont que lus. Une case saturée n'a aucun voisin à allumer : elle ne passe
+    // pas par le noyau et ne lit pas la végétation (les tirages des autres cases ne dépendent que de leur germe).
+    std::size_t nb_batches = (m_fire_front.size() + front_kernel::batch_size - 1) / front_kernel::batch_size;
+    #pragma omp parallel
+    {
+        std::uint32_t thresholds[front_kernel::nb_draws * front_kernel::batch_size];
+        std::uint8_t  drawn_masks[front_kernel::batch_size];
+        std::uint32_t drawn_cells[front_kernel::batch_size];
+        std::uint16_t drawn[front_kernel::batch_size]; // Place dans le lot des cases passées au noyau
+        #pragma omp for schedule(static)
+        for (std::size_t batch = 0; batch < nb_batches; ++batch)
+        {
+            std::size_t start = batch * front_kernel::batch_size;
+            std::size_t count = std::min(front_kernel::batch_size, m_fire_front.size() - start);
+            std::uint8_t* masks = m_front_masks.data() + start;
+            std::size_t nb_drawn = 0;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (m_exhausted_neighbours[m_fire_front.position(start + i)] != saturated)
+                {
+                    drawn[nb_drawn++] = std::uint16_t(i);
+                    continue;
+                }
+                // Un foyer qui n'est plus à son max faiblit à coup sûr, sans tirage
+                bool weakened = (m_fire_front.intensity(start + i) < 255) ||
+                                weakens(m_fire_front.index(start + i) * 52513 + m_time_step);
+                masks[i] = weakened ? std::uint8_t(1u << weakening) : std::uint8_t(0u);
+            }
+            (this->*m_fill_thresholds)(start, drawn, nb_drawn, drawn_cells, thresholds);
+            m_kernel(drawn_cells, thresholds, nb_drawn, m_time_step, drawn_masks);
+            for (std::size_t j = 0; j < nb_drawn; ++j)
+                masks[drawn[j]] = drawn_masks[j];
+#if defined(VALIDATE_THRESHOLDS)
+            validate_masks(start, count, masks);
+#endif
+        }
+    }
+
+    // Fusion dans l'ordre du front : tous les allumages d'abord, puis les foyers qui n'ont pas été rallumés par un
+    // voisin. Le résultat ne dépend donc ni du nombre de threads ni de l'ordre de parcours.
+    // Plus aucune végétation n'est lue pour les tirages : chaque case consomme la sienne à son entrée dans le
+    // front suivant, sans second parcours du front.
+    auto ignite = [this](std::uint32_t t_index, std::uint32_t t_position)
+    {
+        set_fire(t_index, t_position, 255);
+        if (!m_next_front.contains(t_index))
+        {
+            m_next_front.set(t_index, t_position, 255);
+            consume(t_index, t_position);
+        }
+    };
+    for (std::size_t i = 0; i < m_fire_front.size(); ++i)
+    {
+        std::uint32_t f = m_fire_front.cells()[i];
+        std::uint32_t p = m_fire_front.position(i);
+        std::uint8_t mask = m_front_masks[i];
+        if (mask & (1u << SouthNorth)) ignite(f + m_geometry, south(p));
+        if (mask & (1u << NorthSouth)) ignite(f - m_geometry, north(p));
+        if (mask & (1u << EastWest  )) ignite(f + 1, east(p));
+        if (mask & (1u << WestEast  )) ignite(f - 1, west(p));
+    }
+    for (std::size_t i = 0; i < m_fire_front.size(); ++i)
+    {
+        std::uint32_t f = m_fire_front.cells()[i];
+        if (m_next_front.contains(f))
+            continue;
+        std::uint32_t p = m_fire_front.position(i);
+        std::uint8_t intensity = m_fire_front.intensity(i);
+        if (m_front_masks[i] & (1u << weakening))
+            intensity >>= 1;
+        set_fire(f, p, intensity);
+        if (intensity > 0)
+        {
+            m_next_front.set(f, p, intensity);
+            consume(f, p);
+        }
+    }
+
+    // Foyers de l'échéancier : intensité et végétation écrites sans tirage. Aucun n'est voisin d'une case en feu
+    // qui pourrait l'allumer, ni n'a de voisin à allumer : la phase parallèle ne les a pas lus.
+    m_decay_wheel.advance(m_time_step, [this](DecayWheel::Cell t_cell, std::uint8_t t_intensity)
+    {
+        set_fire(t_cell.index, t_cell.position, t_intensity);
+        if (t_intensity > 0)
+            consume(t_cell.index, t_cell.position);
+    });
+
+    // Foyers affaiblis dont l'extinction ne dépend plus d'aucun tirage (carte de feu de ce pas complète) : ils
+    // passent dans l'échéancier. Parcours à rebours : la case qui prend la place d'une case retirée a déjà été vue.
+    m_fire_front.swap(m_next_front);
+    for (std::size_t i = m_fire_front.size(); i-- > 0;)
+    {
+        std::uint8_t intensity = m_fire_front.intensity(i);
+        if ((intensity != 255) && burns_down(m_fire_front.position(i)))
+        {
+            m_decay_wheel.schedule(m_time_step, m_fire_front.cells()[i], m_fire_front.position(i), intensity);
+            m_fire_front.erase(m_fire_front.index(i));
+        }
+    }
+    m_tiles_up_to_date = false;
+}
+// --------------------------------------------------------------------------------------------------------------------
+template<bool PowerOfTwo>
+void Model::refresh_tiles_variant()
+{
+    std::fill(m_active_tiles.begin(), m_active_tiles.end(), 0u);
+    auto activate = [this](std::size_t t_index)
+    {
+        LexicoIndices coord = decode<PowerOfTwo>(t_index);
+        m_active_tiles[(coord.row / tile_size) * m_tiles_per_side + coord.column / tile_size] = 1u;
+    };
+    for (std::size_t i = 0; i < m_fire_front.size(); ++i)
+        activate(m_fire_front.index(i));
+    m_decay_wheel.for_each([&activate](DecayWheel::Cell t_cell) { activate(t_cell.index); });
+    m_nb_active_tiles = std::size_t(std::count(m_active_tiles.begin(), m_active_tiles.end(), 1u));
+    m_tiles_up_to_date = true;
+}
+// --------------------------------------------------------------------------------------------------------------------
+template<typename Function>
+void Model::for_each_block(unsigned t_tile_row, Function&& t_function) const
+{
+    // Appelle t_function(bloc, tuile) sur les blocs à parcourir de la ligne de tuiles t_tile_row
+    unsigned row_begin = t_tile_row * tile_size;
+    unsigned row_end   = std::min(row_begin + tile_size, m_geometry);
+    for (unsigned tile_column = 0; tile_column < m_tiles_per_side; ++tile_column)
+    {
+        std::size_t tile = std::size_t(t_tile_row) * m_tiles_per_side + tile_column;
+        unsigned column_begin = tile_column * tile_size;
+        unsigned column_end   = std::min(column_begin + tile_size, m_geometry);
+        if (m_active_tiles[tile])
+        {
+            t_function(Block{row_begin, row_end, column_begin, column_end}, tile);
+            continue;
+        }
+        // Tuile sans feu : seuls ses bords qui touchent une tuile active peuvent s'allumer. Chaque case n'est
+        // visitée qu'une fois (sa végétation est décrémentée au passage).
+        bool north = tile_active(t_tile_row - 1, tile_column), south = tile_active(t_tile_row + 1, tile_column);
+        bool west  = tile_active(t_tile_row, tile_column - 1), east  = tile_active(t_tile_row, tile_column + 1);
+        unsigned top = row_begin, bottom = row_end;
+        if (north)
+        {
+            t_function(Block{top, top + 1, column_begin, column_end}, tile);
+            top += 1;
+        }
+        if (south && (bottom > top))
+        {
+            t_function(Block{bottom - 1, bottom, column_begin, column_end}, tile);
+            bottom -= 1;
+        }
+        if (top >= bottom)
+            continue;
+        if (west)
+            t_function(Block{top, bottom, column_begin, column_begin + 1}, tile);
+        if (east && (!west || (column_end - 1 > column_begin)))
+            t_function(Block{top, bottom, column_end - 1, column_end}, tile);
+    }
+}
+// --------------------------------------------------------------------------------------------------------------------
+void Model::gather_block(Block const& t_block, std::size_t t_tile, ThreadBuffer& t_buffer)
+{
+    // Chaque case du bloc lit ses quatre voisins et décide seule de son état : aucune écriture concurrente.
+    // Le nouvel état est écrit dans un tampon, recopié dans la carte de feu une fois tous les blocs parcourus.
+    // Les tirages sont ceux de scatter_step : germe et direction du foyer voisin, végétation de la case.
+    bool burning = false;
+    for (std::size_t row = t_block.row_begin; row < t_block.row_end; ++row)
+    {
+        // La bordure n'est jamais en feu : pas de test sur les bords de la carte. Un bloc ne déborde pas de sa tuile :
+        // les cases d'une de ses lignes se suivent dans les cartes, rangées par lignes ou par tuiles.
+        std::size_t f = row * m_geometry + t_block.column_begin;
+        std::size_t p = position(row, t_block.column_begin);
+        for (std::size_t column = t_block.column_begin; column < t_block.column_end; ++column, ++f, ++p)
+        {
+            std::uint8_t green = m_vegetation_map[p];
+            std::uint8_t fire  = m_fire_map.get(p), previous = fire;
+            std::uint8_t north = m_fire_map.get(Model::north(p)), south = m_fire_map.get(Model::south(p));
+            std::uint8_t west  = m_fire_map.get(Model::west(p)),  east  = m_fire_map.get(Model::east(p));
+            // Sans végétation, le seuil d'allumage est nul : aucun tirage à faire
+            bool ignited = (green > 0) && (
+                ((north > 0) && ignites(SouthNorth, (f - m_geometry) + m_time_step, north, green)) ||
+                ((south > 0) && ignites(NorthSouth, (f + m_geometry) * 13427 + m_time_step, south, green)) ||
+                ((west  > 0) && ignites(EastWest, (f - 1) * 13427 * 13427 + m_time_step, west, green)) ||
+                ((east  > 0) && ignites(WestEast, (f + 1) * 13427 * 13427 * 13427 + m_time_step, east, green)) );
+
+            if (ignited)
+                fire = 255;
+            else if (fire == 255)
+            {
+                if (weakens(f * 52513 + m_time_step))
+                    fire >>= 1;
+            }
+            else
+                fire >>= 1;
+
+            m_fire_buffer.set(p, fire);
+            if (fire != previous)
+                t_buffer.digest += state_digest::change(state_digest::Fire, f, previous, fire);
+            if (fire > 0)
+            {
+                burning = true;
+                t_buffer.burning.push_back({std::uint32_t(f), std::uint32_t(p)});
+                t_buffer.intensities.push_back(fire);
+                if (green > 0)
+                {
+                    m_vegetation_map[p] = green - 1;
+                    t_buffer.digest += state_digest::change(state_digest::Vegetation, f, green, green - 1);
+                    t_buffer.burnt  += (green == 255);
+                    // Le masque des voisins peut appartenir à un autre thread : mis à jour après le parcours
+                    if (green == 1)
+                        t_buffer.exhausted.push_back(std::uint32_t(p));
+                }
+            }
+        }
+    }
+    if (burning)
+        m_next_active_tiles[t_tile] = 1u;
+}
+// --------------------------------------------------------------------------------------------------------------------
+void Model::gather_step()
+{
+    // Les lignes de tuiles sont réparties entre les threads : chaque tuile (et sa marque d'activité) n'est écrite que
+    // par un thread. Les tuiles actives du pas suivant sont celles où une case parcourue reste ou devient en feu.
+    // Les foyers de l'échéancier sont dans la carte de feu et leurs tuiles sont actives : ils sont traités comme
+    // les autres et reviennent dans le front.
+    m_next_front.clear();
+    m_decay_wheel.clear();
+    reset_thread_buffers();
+    std::fill(m_next_active_tiles.begin(), m_next_active_tiles.end(), 0u);
+    #pragma omp parallel
+    {
+        ThreadBuffer& buffer = m_thread_buffers[omp_get_thread_num()];
+        #pragma omp for schedule(static)
+        for (unsigned tile_row = 0; tile_row < m_tiles_per_side; ++tile_row)
+            for_each_block(tile_row, [this, &buffer](Block const& block, std::size_t tile)
+            {
+                gather_block(block, tile, buffer);
+                buffer.swept += std::size_t(block.row_end - block.row_begin) * (block.column_end - block.column_begin);
+            });
+        // Barrière implicite de la boucle précédente : toutes les lectures de l'ancien état sont terminées
+        #pragma omp for schedule(static)
+        for (unsigned tile_row = 0; tile_row < m_tiles_per_side; ++tile_row)
+            for_each_block(tile_row, [this](Block const& block, std::size_t)
+            {
+                for (std::size_t row = block.row_begin; row < block.row_end; ++row)
+                    m_fire_map.copy(m_fire_buffer, position(row, block.column_begin),
+                                    block.column_end - block.column_begin);
+            });
+    }
+    // Répartition statique : la fusion dans l'ordre des threads redonne l'ordre des lignes de tuiles
+    for (auto const& buffer : m_thread_buffers)
+    {
+        for (std::size_t i = 0; i < buffer.burning.size(); ++i)
+            m_next_front.set(buffer.burning[i].index, buffer.burning[i].position, buffer.intensities[i]);
+        for (std::uint32_t p : buffer.exhausted)
+            exhaust(p);
+        m_digest += buffer.digest;
+        m_burnt_cells += buffer.burnt;
+        m_processed_cells += buffer.swept;
+    }
+    m_active_tiles.swap(m_next_active_tiles);
+    m_nb_active_tiles = std::size_t(std::count(m_active_tiles.begin(), m_active_tiles.end(), 1u));
+    m_tiles_up_to_date = true;
+    m_fire_front.swap(m_next_front);
+}
+// --------------------------------------------------------------------------------------------------------------------
+double Model::calibrate_crossover()
+{
+    // Un pas de chaque parcours sur une petite carte entièrement en feu : les deux traitent alors le même nombre de
+    // cases et le rapport de leurs durées donne la densité du front à partir de laquelle Gather est plus rapide.
+    constexpr unsigned probe_geometry = 128;
+    Model probe(1., probe_geometry, {0., 0.}, {0u, 0u});
+    auto ignite_all = [&probe]()
+    {
+        for (std::size_t row = 0; row < probe_geometry; ++row)
+            for (std::size_t column = 0; column < probe_geometry; ++column)
+            {
+                std::size_t p = probe.position(row, column);
+                probe.m_fire_map.set(p, 255u);
+                probe.m_vegetation_map[p] = 255u;
+                probe.m_fire_front.set(row * probe_geometry + column, p, 255u);
+            }
+    };
+    double scatter_time = std::numeric_limits<double>::max(), gather_time = std::numeric_limits<double>::max();
+    for (int trial = 0; trial < 3; ++trial)
+    {
+        ignite_all();
+        auto start = std::chrono::steady_clock::now();
+        probe.scatter_step();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        scatter_time = std::min(scatter_time, elapsed.count());
+
+        ignite_all();
+        probe.refresh_tiles();
+        start = std::chrono::steady_clock::now();
+        probe.gather_step();
+        elapsed = std::chrono::steady_clock::now() - start;
+        gather_time = std::min(gather_time, elapsed.count());
+    }
+    return gather_time / scatter_time;
+}
+// --------------------------------------------------------------------------------------------------------------------
+double Model::alpha(Direction t_direction) const
+{
+    switch (t_direction)
+    {
+    case SouthNorth: return alphaSouthNorth;
+    case NorthSouth: return alphaNorthSouth;
+    case EastWest:   return alphaEastWest;
+    default:         return alphaWestEast;
+    }
+}
+// --------------------------------------------------------------------------------------------------------------------
+bool Model::ignites(Direction t_direction, std::size_t t_seed, std::uint8_t t_power, std::uint8_t t_green_power) const
+{
+    bool ignition = pseudo_random_raw(t_seed, m_time_step) < ignition_threshold(t_direction, t_power, t_green_power);
+#if defined(VALIDATE_THRESHOLDS)
+    // Vérification par rapport au calcul flottant d'origine
+    double tirage = pseudo_random(t_seed, m_time_step);
+    double correction = log_factor(t_power) * log_factor(t_green_power);
+    if (ignition != (tirage < alpha(t_direction) * p1 * correction))
+        throw std::logic_error("Seuil d'allumage incohérent au pas de temps " + std::to_string(m_time_step));
+#endif
+    return ignition;
+}
+// --------------------------------------------------------------------------------------------------------------------
+bool Model::weakens(std::size_t t_seed) const
+{
+    bool weakening = pseudo_random_raw(t_seed, m_time_step) < m_extinction_threshold;
+#if defined(VALIDATE_THRESHOLDS)
+    if (weakening != (pseudo_random(t_seed, m_time_step) < p2))
+        throw std::logic_error("Seuil d'extinction incohérent au pas de temps " + std::to_string(m_time_step));
+#endif
+    return weakening;
+}
+// --------------------------------------------------------------------------------------------------------------------
+#if defined(VALIDATE_THRESHOLDS)
+void Model::validate_masks(std::size_t t_start, std::size_t t_count, std::uint8_t const* t_masks) const
+{
+    // Même décision que le test tirage par tirage (lui-même vérifié par rapport au calcul flottant)
+    for (std::size_t i = 0; i < t_count; ++i)
+    {
+        std::size_t f = m_fire_front.index(t_start + i);
+        std::uint8_t intensity = m_fire_front.intensity(t_start + i);
+        // Tests explicites des bords : vérifie aussi la bordure des cartes
+        LexicoIndices coord = get_lexicographic_from_index(f);
+        std::size_t p = position(coord.row, coord.column);
+        if (p != m_fire_front.position(t_start + i))
+            throw std::logic_error("Position incohérente dans le front au pas de temps " + std::to_string(m_time_step));
+        unsigned expected = 0;
+        if ((coord.row < m_geometry - 1) &&
+            ignites(SouthNorth, f + m_time_step, intensity, m_vegetation_map[south(p)]))
+            expected |= 1u << SouthNorth;
+        if ((coord.row > 0) &&
+            ignites(NorthSouth, f * 13427 + m_time_step, intensity, m_vegetation_map[north(p)]))
+            expected |= 1u << NorthSouth;
+        if ((coord.column < m_geometry - 1) &&
+            ignites(EastWest, f * 13427 * 13427 + m_time_step, intensity, m_vegetation_map[east(p)]))
+            expected |= 1u << EastWest;
+        if ((coord.column > 0) &&
+            ignites(WestEast, f * 13427 * 13427 * 13427 + m_time_step, intensity, m_vegetation_map[west(p)]))
+            expected |= 1u << WestEast;
+        if ((intensity < 255) || weakens(f * 52513 + m_time_step))
+            expected |= 1u << weakening;
+        std::uint8_t exhausted = 0;
+        exhausted |= (m_vegetation_map[south(p)] == 0) ? 1u << SouthNorth : 0u;
+        exhausted |= (m_vegetation_map[north(p)] == 0) ? 1u << NorthSouth : 0u;
+        exhausted |= (m_vegetation_map[east(p)] == 0)  ? 1u << EastWest   : 0u;
+        exhausted |= (m_vegetation_map[west(p)] == 0)  ? 1u << WestEast   : 0u;
+        if (m_exhausted_neighbours[p] != exhausted)
+            throw std::logic_error("Masque de saturation incohérent au pas de temps " + std::to_string(m_time_step));
+        if (t_masks[i] != expected)
+            throw std::logic_error(std::string("Noyau de tirage ") + front_kernel::name() +
+                                   " incohérent au pas de temps " + std::to_string(m_time_step));
+    }
+}
+// --------------------------------------------------------------------------------------------------------------------
+void Model::validate_digest() const
+{
+    if (m_digest != compute_digest())
+        throw std::logic_error("Empreinte incrémentale incohérente au pas de temps " + std::to_string(m_time_step));
+}
+#endif
+// ====================================================================================================================
+std::uint64_t Model::compute_digest() const
+{
+    std::uint64_t digest = 0;
+    for (std::size_t row = 0; row < m_geometry; ++row)
+        for (std::size_t column = 0; column < m_geometry; ++column)
+        {
+            std::size_t f = row * m_geometry + column, p = position(row, column);
+            digest += state_digest::key(state_digest::Fire, f, m_fire_map.get(p));
+            digest += state_digest::key(state_digest::Vegetation, f, m_vegetation_map[p]);
+        }
+    return digest;
+}
+// --------------------------------------------------------------------------------------------------------------------
+std::vector<std::uint8_t> Model::without_border(std::vector<std::uint8_t> const& t_map) const
+{
+    std::vector<std::uint8_t> map(std::size_t(m_geometry) * m_geometry);
+    for (std::size_t row = 0; row < m_geometry; ++row)
+        for (std::size_t column = 0; column < m_geometry; column += tile_size)
+            std::copy_n(t_map.begin() + position(row, column), std::min<std::size_t>(tile_size, m_geometry - column),
+                        map.begin() + row * m_geometry + column);
+    return map;
+}
+// --------------------------------------------------------------------------------------------------------------------
+std::vector<std::uint8_t> Model::fire_map() const
+{
+    std::vector<std::uint8_t> map(std::size_t(m_geometry) * m_geometry);
+    for (std::size_t row = 0; row < m_geometry; ++row)
+        for (std::size_t column = 0; column < m_geometry; ++column)
+            map[row * m_geometry + column] = m_fire_map.get(position(row, column));
+    return map;
+}
+// --------------------------------------------------------------------------------------------------------------------
+std::size_t Model::get_index_from_lexicographic_indices(LexicoIndices t_lexico_indices) const
+{
+    return t_lexico_indices.row * this->geometry() + t_lexico_indices.column;
+}
+// --------------------------------------------------------------------------------------------------------------------
+auto Model::get_lexicographic_from_index(std::size_t t_global_index) const -> LexicoIndices
+{
+    LexicoIndices ind_coords;
+    ind_coords.row = t_global_index / this->geometry();
+    ind_coords.column = t_global_index % this->geometry();
+    return ind_coords;
 }
\ No newline at end of file
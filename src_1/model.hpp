@@ -1,56 +1,347 @@
-#pragma once
-#include <cstdint>
-#include <array>
-#include <vector>
-#include <unordered_map>
-#include <sstream>    // Pour std::stringstream
-#include <iomanip>    // Pour std::setw et std::setfill
-#include <iostream>
-#include <math.h>
-#include <openssl/sha.h> // Pour SHA-1
-
-/**
- * @brief 
- * 
- */
-class Model
-{
-public:
-    struct LexicoIndices
-    {
-        unsigned row, column;
-    };
-
-    Model( double t_length, unsigned t_discretization, std::array<double,2> t_wind,
-           LexicoIndices t_start_fire_position, double t_max_wind = 60. );
-    Model( Model const & ) = delete;
-    Model( Model      && ) = delete;
-    ~Model() = default;
-
-    Model& operator = ( Model const & ) = delete;
-    Model& operator = ( Model      && ) = delete;
-
-    bool update();
-
-    unsigned geometry() const { return m_geometry; }
-    std::vector<std::uint8_t> vegetal_map() const { return m_vegetation_map; }
-    std::vector<std::uint8_t> fire_map() const { return m_fire_map; }
-    std::size_t time_step() const { return m_time_step; }
-
-private:
-    std::size_t   get_index_from_lexicographic_indices( LexicoIndices t_lexico_indices  ) const;
-    LexicoIndices get_lexicographic_from_index        ( std::size_t t_global_index ) const;
-
-    double m_length;                    // Taille du carré représentant le terrain (en km)
-    double m_distance;                  // Taille d'une case du terrain modélisé
-    std::size_t m_time_step;            // Dernier numéro du pas de temps calculé
-    unsigned m_geometry;                // Taille en nombre de cases de la carte 2D
-    std::array<double,2> m_wind{0.,0.}; // Vitesse et direction du vent suivant les axes x et y en km/h
-    double m_wind_speed;                // Norme euclidienne de la vitesse du vent
-    double m_max_wind; //+ Vitesse à partir de laquelle le feu ne peut pas se propager dans le sens opposé à celui du vent.
-    std::vector<std::uint8_t> m_vegetation_map, m_fire_map;
-    double p1{0.}, p2{0.};
-    double alphaEastWest, alphaWestEast, alphaSouthNorth, alphaNorthSouth;
-
-    std::unordered_map<std::size_t, std::uint8_t> m_fire_front;
-};
+#pragma once
+#include <cstdint>
+#include <array>
+#include <vector>
+#include "decay_wheel.hpp"
+#include "dirty_tiles.hpp"
+#include "fire_front.hpp"
+#include "fire_map.hpp"
+#include "front_kernel.hpp"
+#include "map_view.hpp"
+#include "state_digest.hpp"
+#include <iostream>
+#include <math.h>
+
+/**
+ * @brief 
+ * 
+ */
+class Model
+{
+public:
+    struct LexicoIndices
+    {
+        unsigned row, column;
+    };
+
+    Model( double t_length, unsigned t_discretization, std::array<double,2> t_wind,
+           LexicoIndices t_start_fire_position, double t_max_wind = 60. );
+    Model( Model const & ) = delete;
+    Model( Model      && ) = delete;
+    ~Model() = default;
+
+    Model& operator = ( Model const & ) = delete;
+    Model& operator = ( Model      && ) = delete;
+
+    // Parcours du pas de temps : depuis les foyers du front (chaque foyer allume ses voisins) ou sur les tuiles
+    // actives de la carte (chaque case lit ses voisins en feu), préférable quand le front est dense.
+    // Adaptive choisit à chaque pas selon la densité du front dans les tuiles actives.
+    // Tous donnent exactement la même évolution.
+    enum UpdateKernel { Scatter = 0, Gather, Adaptive };
+
+    bool update();
+
+    // Résumé d'un pas de temps calculé par advance
+    struct StepSummary
+    {
+        std::size_t  time_step;   // Numéro du pas de temps
+        std::size_t  front_size;  // Cases en feu à la fin du pas
+        std::size_t  burnt_cells; // Cases touchées par le feu depuis le début (végétation entamée)
+        UpdateKernel kernel;      // Parcours utilisé (Scatter ou Gather)
+    };
+    // Calcule jusqu'à t_nb_steps pas de temps à la suite, sans rien afficher ni copier les cartes entre deux pas,
+    // et ajoute le résumé de chacun à t_summaries. S'arrête au pas où le feu s'éteint (dernier résumé, front vide).
+    // Renvoie, comme update(), vrai si le feu brûle encore.
+    bool advance( std::size_t t_nb_steps, std::vector<StepSummary> & t_summaries );
+
+    void set_update_kernel( UpdateKernel t_kernel ) { m_update_kernel = t_kernel; }
+    UpdateKernel update_kernel() const { return m_update_kernel; }
+    // Parcours effectivement utilisé au dernier pas de temps (Scatter ou Gather)
+    UpdateKernel last_kernel() const { return m_last_kernel; }
+    // Nombre de pas de temps faits avec le parcours t_kernel (Scatter ou Gather) depuis le début. Le modèle n'écrit
+    // rien : c'est au programme de rendre compte des parcours choisis par Adaptive, au rythme qui lui convient.
+    std::size_t kernel_steps( UpdateKernel t_kernel ) const { return m_kernel_steps[t_kernel]; }
+
+    // Ordre du front : ordre d'insertion des foyers, ou tri à chaque pas le long d'une courbe de Morton (bits des
+    // numéros de ligne et de colonne entrelacés) ou ligne par ligne, pour que des foyers successifs du front soient
+    // aussi voisins dans les cartes. L'évolution ne dépend pas de l'ordre du front. Morton et Rows sont
+    // expérimentaux : bench_order ne mesure aucun gain de temps, Insertion reste l'ordre par défaut.
+    enum FrontOrder { Insertion = 0, Morton, Rows };
+    void set_front_order( FrontOrder t_order )
+    {
+        m_front_order = t_order;
+        if (t_order != Insertion)
+            m_fire_front.reserve_sort();
+    }
+    FrontOrder front_order() const { return m_front_order; }
+
+    // Densité du front (cases en feu / cases des tuiles actives) au-delà de laquelle Adaptive choisit Gather.
+    // Sans valeur fournie (valeur nulle), elle est mesurée au premier pas de temps par calibrate_crossover().
+    void   set_crossover( double t_density ) { m_crossover = t_density; }
+    double crossover() const { return m_crossover; }
+    static double calibrate_crossover();
+
+    unsigned geometry() const { return m_geometry; }
+    // Cartes sans leur bordure, ligne par ligne
+    std::vector<std::uint8_t> vegetal_map() const { return without_border(m_vegetation_map); }
+    std::vector<std::uint8_t> fire_map() const;
+    // Mêmes cartes, sans copie (voir map_view.hpp)
+    MapView vegetal_view() const
+    {
+        return MapView(m_vegetation_map.data(), m_geometry, m_geometry, m_stride, position(0, 0), false,
+                       view_tile_size);
+    }
+    MapView fire_view() const
+    {
+        return MapView(m_fire_map.data(), m_geometry, m_geometry, m_stride, position(0, 0), FireMap::packed,
+                       view_tile_size);
+    }
+    // Copie unique des deux cartes, qui reste valide pendant que le modèle avance
+    MapSnapshot snapshot() const { return MapSnapshot(m_time_step, fire_view(), vegetal_view()); }
+    std::size_t time_step() const { return m_time_step; }
+    // Empreinte des cartes de feu et de végétation (voir state_digest.hpp), tenue à jour en O(1) par écriture
+    std::uint64_t digest() const { return m_digest; }
+    std::size_t   burnt_cells() const { return m_burnt_cells; }
+    // Cases parcourues depuis le début, cumulées sur les pas de temps : foyers du front et de l'échéancier pour un
+    // pas Scatter, cases des blocs balayés pour un pas Gather (travail réellement fait, bien moindre que n² par pas)
+    std::size_t   processed_cells() const { return m_processed_cells; }
+    // Tuiles dont une case a pu changer depuis le dernier appel à clear_changed_tiles() (toutes à la construction),
+    // pour l'affichage incrémental. Tenues à jour seulement après track_changes(true) : une case ne change que si
+    // elle brûle avant ou après le pas, ce sont donc les tuiles actives de part et d'autre de chaque pas.
+    void track_changes( bool t_track ) { m_track_changes = t_track; }
+    DirtyTiles const & changed_tiles() const { return m_changed_tiles; }
+    void clear_changed_tiles() { m_changed_tiles.clear(); }
+
+private:
+    // Direction de propagation, repérée par le coefficient de vent associé
+    enum Direction { SouthNorth = 0, NorthSouth, EastWest, WestEast };
+
+    void reserve_thread_buffers();
+    void reset_thread_buffers();
+    UpdateKernel choose_kernel();
+    void step( UpdateKernel t_kernel );
+    void scatter_step();
+    void sort_front() { (this->*m_sort_front)(); }
+    // Cases en feu : front et foyers confiés à l'échéancier d'extinction
+    std::size_t burning_cells() const { return m_fire_front.size() + m_decay_wheel.size(); }
+    // Vrai si le foyer affaibli en t_position n'a plus aucun voisin à allumer (voisinage saturé) et ne peut plus être
+    // rallumé : plus de végétation, ou plus aucun voisin en feu (voisins épuisés : ils ne se rallumeront pas).
+    // Son extinction ne dépend alors plus d'aucun tirage.
+    bool burns_down( std::size_t t_position ) const
+    {
+        return (m_exhausted_neighbours[t_position] == saturated) &&
+               ((m_vegetation_map[t_position] == 0) ||
+                ((m_fire_map.get(north(t_position)) | m_fire_map.get(south(t_position)) |
+                  m_fire_map.get(west(t_position))  | m_fire_map.get(east(t_position))) == 0));
+    }
+    // La carte est découpée en tuiles de tile_size x tile_size cases ; une tuile est active si une de ses cases
+    // est en feu. Gather parcourt les tuiles actives et, dans les tuiles voisines, la seule ligne ou colonne qui
+    // touche une tuile active : ailleurs aucune case n'a de voisin en feu et son état ne change pas.
+    static constexpr unsigned tile_size = 64;
+#if defined(TILED_MAPS)
+    static constexpr unsigned view_tile_size = tile_size;
+#else
+    static constexpr unsigned view_tile_size = 0;
+#endif
+    // Bloc rectangulaire de cases d'une tuile (bornes de fin exclues)
+    struct Block
+    {
+        unsigned row_begin, row_end, column_begin, column_end;
+    };
+    void refresh_tiles() { (this->*m_refresh_tiles)(); }
+    void mark_changed_tiles();
+    bool tile_active( unsigned t_tile_row, unsigned t_tile_column ) const
+    {
+        return (t_tile_row < m_tiles_per_side) && (t_tile_column < m_tiles_per_side) &&
+               (m_active_tiles[t_tile_row * m_tiles_per_side + t_tile_column] != 0);
+    }
+    template<typename Function> void for_each_block( unsigned t_tile_row, Function && t_function ) const;
+    struct ThreadBuffer;
+    void gather_block( Block const & t_block, std::size_t t_tile, ThreadBuffer & t_buffer );
+    void gather_step();
+
+    double alpha  ( Direction t_direction ) const;
+    bool   ignites( Direction t_direction, std::size_t t_seed, std::uint8_t t_power, std::uint8_t t_green_power ) const;
+    bool   weakens( std::size_t t_seed ) const;
+#if defined(VALIDATE_THRESHOLDS)
+    void   validate_masks( std::size_t t_start, std::size_t t_count, std::uint8_t const * t_masks ) const;
+    void   validate_digest() const;
+#endif
+
+    std::uint32_t ignition_threshold( Direction t_direction, std::uint8_t t_power, std::uint8_t t_green_power ) const
+    {
+        return m_ignition_thresholds[(t_direction * 256 + t_power) * 256 + t_green_power];
+    }
+
+    // Variantes spécialisées à la compilation, choisies une fois pour toutes à la construction par select_variants :
+    //   - vent nul (Isotropic) : les quatre directions ont les mêmes seuils d'allumage, lus dans une seule table ;
+    //   - côté de la carte puissance de deux (PowerOfTwo) : ligne et colonne d'une case par décalage et masque.
+    // Les versions génériques servent dans tous les autres cas.
+    void select_variants();
+    // Cases et seuils des tirages (rangés par tirage, voir front_kernel.hpp) des cases t_drawn du lot commençant à
+    // la place t_start du front
+    template<bool Isotropic>
+    void fill_thresholds( std::size_t t_start, std::uint16_t const * t_drawn, std::size_t t_nb_drawn,
+                          std::uint32_t * t_cells, std::uint32_t * t_thresholds ) const;
+    template<bool PowerOfTwo> void refresh_tiles_variant();
+    template<bool PowerOfTwo> void sort_front_variant();
+    template<bool PowerOfTwo>
+    LexicoIndices decode( std::size_t t_index ) const
+    {
+        if constexpr (PowerOfTwo)
+            return {unsigned(t_index >> m_geometry_shift), unsigned(t_index & (m_geometry - 1))};
+        else
+            return get_lexicographic_from_index(t_index);
+    }
+
+    // Nombre de cases stockées, bordure comprise, pour une carte de t_geometry cases de côté : lignes stockées
+    // (lignes de tuiles pour les cartes tuilées) fois leur longueur
+    static std::size_t stored_cells( unsigned t_geometry ) { return stored_rows(t_geometry) * stored_stride(t_geometry); }
+#if defined(TILED_MAPS)
+    static constexpr std::size_t tile_cells = std::size_t(tile_size) * tile_size;
+    static std::size_t stored_rows  ( unsigned t_geometry ) { return (t_geometry + tile_size - 1) / tile_size + 2; }
+    static std::size_t stored_stride( unsigned t_geometry ) { return stored_rows(t_geometry) * tile_cells; }
+    // Position de la case (row, column) dans les cartes stockées par tuiles, avec une bordure d'une tuile
+    std::size_t position( std::size_t t_row, std::size_t t_column ) const
+    {
+        return (t_row / tile_size + 1) * m_stride + (t_column / tile_size + 1) * tile_cells +
+               (t_row % tile_size) * tile_size + t_column % tile_size;
+    }
+    // Voisins de la case t_position ; au bord d'une tuile, case correspondante de la tuile voisine
+    std::size_t north( std::size_t t_position ) const
+    {
+        return (t_position % tile_cells >= tile_size) ? t_position - tile_size
+                                                      : t_position - m_stride + tile_cells - tile_size;
+    }
+    std::size_t south( std::size_t t_position ) const
+    {
+        return (t_position % tile_cells < tile_cells - tile_size) ? t_position + tile_size
+                                                                  : t_position + m_stride - tile_cells + tile_size;
+    }
+    std::size_t west( std::size_t t_position ) const
+    {
+        return (t_position % tile_size != 0) ? t_position - 1 : t_position - tile_cells + tile_size - 1;
+    }
+    std::size_t east( std::size_t t_position ) const
+    {
+        return (t_position % tile_size != tile_size - 1) ? t_position + 1 : t_position + tile_cells - tile_size + 1;
+    }
+#else
+    static std::size_t stored_rows  ( unsigned t_geometry ) { return t_geometry + 2; }
+    static std::size_t stored_stride( unsigned t_geometry ) { return (t_geometry + 3) / 2 * 2; }
+    // Position de la case (row, column) dans les cartes stockées avec leur bordure
+    std::size_t position( std::size_t t_row, std::size_t t_column ) const
+    {
+        return (t_row + 1) * m_stride + t_column + 1;
+    }
+    // Voisins de la case t_position
+    std::size_t north( std::size_t t_position ) const { return t_position - m_stride; }
+    std::size_t south( std::size_t t_position ) const { return t_position + m_stride; }
+    std::size_t west ( std::size_t t_position ) const { return t_position - 1; }
+    std::size_t east ( std::size_t t_position ) const { return t_position + 1; }
+#endif
+    std::vector<std::uint8_t> without_border( std::vector<std::uint8_t> const & t_map ) const;
+    // Allume ou affaiblit la case en tenant l'empreinte à jour
+    void set_fire( std::size_t t_index, std::size_t t_position, std::uint8_t t_intensity )
+    {
+        m_digest += state_digest::change(state_digest::Fire, t_index, m_fire_map.get(t_position), t_intensity);
+        m_fire_map.set(t_position, t_intensity);
+    }
+    // Retire une unité de végétation à une case du front suivant
+    void consume( std::size_t t_index, std::size_t t_position )
+    {
+        std::uint8_t green = m_vegetation_map[t_position];
+        if (green > 0)
+        {
+            m_vegetation_map[t_position] = green - 1;
+            m_digest += state_digest::change(state_digest::Vegetation, t_index, green, green - 1);
+            m_burnt_cells += (green == 255);
+            if (green == 1)
+                exhaust(t_position);
+        }
+    }
+    // La case t_position n'a plus de végétation : ses quatre voisins ne peuvent plus l'allumer
+    void exhaust( std::size_t t_position )
+    {
+        m_exhausted_neighbours[north(t_position)] |= 1u << SouthNorth;
+        m_exhausted_neighbours[south(t_position)] |= 1u << NorthSouth;
+        m_exhausted_neighbours[west(t_position)]  |= 1u << EastWest;
+        m_exhausted_neighbours[east(t_position)]  |= 1u << WestEast;
+    }
+    // Empreinte recalculée sur toute la carte
+    std::uint64_t compute_digest() const;
+
+    std::size_t   get_index_from_lexicographic_indices( LexicoIndices t_lexico_indices  ) const;
+    LexicoIndices get_lexicographic_from_index        ( std::size_t t_global_index ) const;
+
+    double m_length;                    // Taille du carré représentant le terrain (en km)
+    double m_distance;                  // Taille d'une case du terrain modélisé
+    std::size_t m_time_step = 0;        // Dernier numéro du pas de temps calculé
+    unsigned m_geometry;                // Taille en nombre de cases de la carte 2D
+    unsigned m_stride;                  // Longueur (paire) d'une ligne stockée (d'une ligne de tuiles si tuilée)
+    std::array<double,2> m_wind{0.,0.}; // Vitesse et direction du vent suivant les axes x et y en km/h
+    double m_wind_speed;                // Norme euclidienne de la vitesse du vent
+    double m_max_wind; //+ Vitesse à partir de laquelle le feu ne peut pas se propager dans le sens opposé à celui du vent.
+    // Cartes stockées avec une bordure d'une case sans végétation : aucun voisin n'y prend feu, le parcours du
+    // front n'a donc ni à décoder les coordonnées des cases ni à tester les bords de la carte.
+    // Longueur de ligne paire : deux lignes ne partagent jamais un octet de la carte de feu compacte.
+    // Compilées avec TILED_MAPS, les cartes sont rangées par tuiles de tile_size x tile_size cases, chacune d'un
+    // seul tenant (ligne par ligne), les tuiles ligne de tuiles par ligne de tuiles, avec une bordure d'une tuile.
+    // Les cases hors carte des tuiles du bord n'ont pas de végétation et servent aussi de bordure. Un bloc de
+    // gather_step tient alors dans 4 Ko contigus ; en contrepartie, un voisin au bord d'une tuile n'est plus à un
+    // décalage constant (north, south, west, east).
+    std::vector<std::uint8_t> m_vegetation_map;
+    FireMap m_fire_map;
+    // Masque de saturation du voisinage : bit d de la case p à 1 si son voisin dans la direction d n'a plus de
+    // végétation (ou est sur la bordure). Il ne peut plus être allumé, et ce pour toujours puisque la végétation ne
+    // repousse pas. Une case saturée (quatre bits à 1) ne fait aucun tirage d'allumage.
+    static constexpr std::uint8_t saturated = 0xFu;
+    std::vector<std::uint8_t> m_exhausted_neighbours;
+    std::uint64_t m_digest = 0;
+    std::size_t m_burnt_cells = 0;      // Cases dont la végétation est entamée
+    std::size_t m_processed_cells = 0;  // Cases parcourues par les pas de temps (voir processed_cells())
+    double p1{0.}, p2{0.};
+    double alphaEastWest, alphaWestEast, alphaSouthNorth, alphaNorthSouth;
+    std::vector<std::uint32_t> m_ignition_thresholds; // Seuils sur le tirage brut par (direction, puissance du foyer, végétation)
+    std::uint32_t m_extinction_threshold{0};          // Seuil sur le tirage brut équivalent à p2
+
+    // Décisions prises par un thread pendant la phase parallèle de gather_step(), fusionnées ensuite
+    // dans l'ordre des threads : aucune écriture partagée pendant la phase parallèle.
+    struct Cell
+    {
+        std::uint32_t index, position; // Indice dans la carte et position dans les cartes stockées
+    };
+    struct ThreadBuffer
+    {
+        std::vector<Cell>         burning;     // Cases en feu à la fin du pas
+        std::vector<std::uint8_t> intensities; // Intensité de ces foyers
+        std::uint64_t             digest = 0;  // Variation de l'empreinte due au thread
+        std::size_t               burnt  = 0;  // Cases touchées pour la première fois
+        std::size_t               swept  = 0;  // Cases des blocs parcourus
+        std::vector<std::uint32_t> exhausted;  // Positions des cases dont la végétation s'épuise
+    };
+
+    FireFront m_fire_front, m_next_front;     // Foyers actifs et foyers du pas de temps suivant
+    DecayWheel m_decay_wheel;                 // Foyers sortis du front, dont l'extinction est écrite pas à pas
+    front_kernel::Kernel m_kernel;            // Noyau de tirage choisi selon le processeur
+    using FillThresholds = void (Model::*)( std::size_t, std::uint16_t const *, std::size_t, std::uint32_t *,
+                                             std::uint32_t * ) const;
+    FillThresholds m_fill_thresholds;         // Variantes choisies par select_variants
+    void (Model::*m_refresh_tiles)();
+    void (Model::*m_sort_front)();
+    unsigned m_geometry_shift = 0;            // log2(m_geometry) si c'est une puissance de deux
+    std::vector<ThreadBuffer> m_thread_buffers; // Un tampon par thread OpenMP, réservé par reserve_thread_buffers()
+    std::vector<std::uint8_t> m_front_masks;    // Masque de chaque foyer du front calculé par scatter_step
+    UpdateKernel m_update_kernel = Scatter;
+    UpdateKernel m_last_kernel   = Scatter;
+    std::array<std::size_t, 2> m_kernel_steps{}; // Pas de temps faits avec Scatter et avec Gather
+    FrontOrder   m_front_order   = Insertion;
+    double m_crossover = 0.;                 // Densité de bascule vers Gather (0 : à calibrer)
+    FireMap m_fire_buffer;                    // Nouvel état des blocs parcourus par gather_step
+    unsigned m_tiles_per_side;                // Nombre de tuiles par direction
+    std::vector<std::uint8_t> m_active_tiles, m_next_active_tiles; // Tuiles ayant au moins une case en feu
+    std::size_t m_nb_active_tiles = 0;
+    bool m_tiles_up_to_date = false;          // Faux après un pas Scatter : à reconstruire depuis le front
+    DirtyTiles m_changed_tiles;               // Tuiles modifiées depuis clear_changed_tiles()
+    bool m_track_changes = false;
+};
@@ -1,253 +1,692 @@
-#include <string>
-#include <cstdlib>
-#include <cassert>
-#include <iostream>
-#include <thread>
-#include <chrono>
-#include <omp.h>
-
-#include "model.hpp"
-#include "display.hpp"
-
-using namespace std::string_literals;
-using namespace std::chrono_literals;
-
-struct ParamsType
-{
-    double length{1.};
-    unsigned discretization{20u};
-    std::array<double,2> wind{0.,0.};
-    Model::LexicoIndices start{10u,10u};
-};
-
-void analyze_arg( int nargs, char* args[], ParamsType& params )
-{
-    if (nargs ==0) return;
-    std::string key(args[0]);
-    if (key == "-l"s)
-    {
-        if (nargs < 2)
-        {
-            std::cerr << "Manque une valeur pour la longueur du terrain !" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        params.length = std::stoul(args[1]);
-        analyze_arg(nargs-2, &args[2], params);
-        return;
-    }
-    auto pos = key.find("--longueur=");
-    if (pos < key.size())
-    {
-        auto subkey = std::string(key,pos+11);
-        params.length = std::stoul(subkey);
-        analyze_arg(nargs-1, &args[1], params);
-        return;
-    }
-
-    if (key == "-n"s)
-    {
-        if (nargs < 2)
-        {
-            std::cerr << "Manque une valeur pour le nombre de cases par direction pour la discrétisation du terrain !" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        params.discretization = std::stoul(args[1]);
-        analyze_arg(nargs-2, &args[2], params);
-        return;
-    }
-    pos = key.find("--number_of_cases=");
-    if (pos < key.size())
-    {
-        auto subkey = std::string(key, pos+18);
-        params.discretization = std::stoul(subkey);
-        analyze_arg(nargs-1, &args[1], params);
-        return;
-    }
-
-    if (key == "-w"s)
-    {
-        if (nargs < 2)
-        {
-            std::cerr << "Manque une paire de valeurs pour la direction du vent !" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        std::string values =std::string(args[1]);
-        params.wind[0] = std::stod(values);
-        auto pos = values.find(",");
-        if (pos == values.size())
-        {
-            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la vitesse" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        auto second_value = std::string(values, pos+1);
-        params.wind[1] = std::stod(second_value);
-        analyze_arg(nargs-2, &args[2], params);
-        return;
-    }
-    pos = key.find("--wind=");
-    if (pos < key.size())
-    {
-        auto subkey = std::string(key, pos+7);
-        params.wind[0] = std::stoul(subkey);
-        auto pos = subkey.find(",");
-        if (pos == subkey.size())
-        {
-            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la vitesse" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        auto second_value = std::string(subkey, pos+1);
-        params.wind[1] = std::stod(second_value);
-        analyze_arg(nargs-1, &args[1], params);
-        return;
-    }
-
-    if (key == "-s"s)
-    {
-        if (nargs < 2)
-        {
-            std::cerr << "Manque une paire de valeurs pour la position du foyer initial !" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        std::string values =std::string(args[1]);
-        params.start.column = std::stod(values);
-        auto pos = values.find(",");
-        if (pos == values.size())
-        {
-            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la position du foyer initial" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        auto second_value = std::string(values, pos+1);
-        params.start.row = std::stod(second_value);
-        analyze_arg(nargs-2, &args[2], params);
-        return;
-    }
-    pos = key.find("--start=");
-    if (pos < key.size())
-    {
-        auto subkey = std::string(key, pos+8);
-        params.start.column = std::stoul(subkey);
-        auto pos = subkey.find(",");
-        if (pos == subkey.size())
-        {
-            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la vitesse" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        auto second_value = std::string(subkey, pos+1);
-        params.start.row = std::stod(second_value);
-        analyze_arg(nargs-1, &args[1], params);
-        return;
-    }
-}
-
-ParamsType parse_arguments( int nargs, char* args[] )
-{
-    if (nargs == 0) return {};
-    if ( (std::string(args[0]) == "--help"s) || (std::string(args[0]) == "-h") )
-    {
-        std::cout << 
-R"RAW(Usage : simulation [option(s)]
-  Lance la simulation d'incendie en prenant en compte les [option(s)].
-  Les options sont :
-    -l, --longueur=LONGUEUR     Définit la taille LONGUEUR (réel en km) du carré représentant la carte de la végétation.
-    -n, --number_of_cases=N     Nombre n de cases par direction pour la discrétisation
-    -w, --wind=VX,VY            Définit le vecteur vitesse du vent (pas de vent par défaut).
-    -s, --start=COL,ROW         Définit les indices I,J de la case où commence l'incendie (milieu de la carte par défaut)
-)RAW";
-        exit(EXIT_SUCCESS);
-    }
-    ParamsType params;
-    analyze_arg(nargs, args, params);
-    return params;
-}
-
-bool check_params(ParamsType& params)
-{
-    bool flag = true;
-    if (params.length <= 0)
-    {
-        std::cerr << "[ERREUR FATALE] La longueur du terrain doit être positive et non nulle !" << std::endl;
-        flag = false;
-    }
-
-    if (params.discretization <= 0)
-    {
-        std::cerr << "[ERREUR FATALE] Le nombre de cellules par direction doit être positive et non nulle !" << std::endl;
-        flag = false;
-    }
-
-    if ( (params.start.row >= params.discretization) || (params.start.column >= params.discretization) )
-    {
-        std::cerr << "[ERREUR FATALE] Mauvais indices pour la position initiale du foyer" << std::endl;
-        flag = false;
-    }
-    
-    return flag;
-}
-
-void display_params(ParamsType const& params)
-{
-    std::cout << "Parametres définis pour la simulation : \n"
-              << "\tTaille du terrain : " << params.length << std::endl 
-              << "\tNombre de cellules par direction : " << params.discretization << std::endl 
-              << "\tVecteur vitesse : [" << params.wind[0] << ", " << params.wind[1] << "]" << std::endl
-              << "\tPosition initiale du foyer (col, ligne) : " << params.start.column << ", " << params.start.row << std::endl;
-}
-
-int main( int nargs, char* args[] )
-{
-    auto params = parse_arguments(nargs-1, &args[1]);
-    display_params(params);
-    if (!check_params(params)) return EXIT_FAILURE;
-
-    auto displayer = Displayer::init_instance( params.discretization, params.discretization );
-    auto simu = Model( params.length, params.discretization, params.wind,
-                       params.start);
-    SDL_Event event;
-
-    std::chrono::duration<double> total_update_time{0};  
-    std::chrono::duration<double> total_display_time{0};  
-    std::chrono::duration<double> total_iteration_time{0};
-    int iteration_count = 0;
-
-    while (true)
-    {
-        auto start_iter = std::chrono::high_resolution_clock::now();
-
-        auto start_update = std::chrono::high_resolution_clock::now();
-        bool running = simu.update();
-        auto end_update = std::chrono::high_resolution_clock::now();
-        total_update_time += end_update - start_update;
-
-        if (!running) break;
-
-        if ((simu.time_step() & 31) == 0)
-            std::cout << "Time step " << simu.time_step() << "\n===============" << std::endl;
-
-        auto start_display = std::chrono::high_resolution_clock::now();
-        displayer->update(simu.vegetal_map(), simu.fire_map());
-        auto end_display = std::chrono::high_resolution_clock::now();
-        total_display_time += end_display - start_display;
-
-        if (SDL_PollEvent(&event) && event.type == SDL_QUIT)
-            break;
-
-        auto end_iter = std::chrono::high_resolution_clock::now();
-        total_iteration_time += end_iter - start_iter;
-        iteration_count++;
-    }
-
-    if (iteration_count > 0) {
-        double mean_update_time = total_update_time.count() / iteration_count;
-        double mean_display_time = total_display_time.count() / iteration_count;
-        double mean_iteration_time = total_iteration_time.count() / iteration_count;
-
-        std::cout << "Temps moyen pour chaque pas de temps (simu.update()): " 
-                  << mean_update_time << " seconds" << std::endl;
-        std::cout << "Temps moyen pour l'affichage (displayer->update()): " 
-                  << mean_display_time << " seconds" << std::endl;
-        std::cout << "Temps moyen pour chaque itération: " 
-                  << mean_iteration_time << " seconds" << std::endl;
-    }
-
-    return EXIT_SUCCESS;
-}
+#include <string>
+#include <cstdlib>
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <omp.h>
+
+#include "model.hpp"
+#include "display.hpp"
+#include "verifier.hpp"
+#include "merkle.hpp"
+#include "snapshot_buffer.hpp"
+
+using namespace std::string_literals;
+using namespace std::chrono_literals;
+
+struct ParamsType
+{
+    double length{1.};
+    unsigned discretization{20u};
+    std::array<double,2> wind{0.,0.};
+    Model::LexicoIndices start{10u,10u};
+    Model::UpdateKernel kernel{Model::Adaptive};
+    Model::FrontOrder order{Model::Insertion};
+    double crossover{0.};
+    Verifier::Cadence checksum{Verifier::Periodic};
+    std::size_t checksum_period{1};
+    Verifier::Method digest{Verifier::Sha1};
+    std::string merkle_log{};
+    std::size_t batch{1};
+    unsigned viewport{1024u};
+    bool render_thread{true};
+    std::size_t render_period{1};
+};
+
+Model::UpdateKernel parse_kernel( std::string const& name )
+{
+    if (name == "scatter"s) return Model::Scatter;
+    if (name == "gather"s ) return Model::Gather;
+    if (name == "auto"s   ) return Model::Adaptive;
+    std::cerr << "Parcours inconnu : " << name << " (scatter, gather ou auto)" << std::endl;
+    exit(EXIT_FAILURE);
+}
+
+Model::FrontOrder parse_order( std::string const& name )
+{
+    if (name == "insertion"s) return Model::Insertion;
+    if (name == "morton"s   ) return Model::Morton;
+    if (name == "rows"s     ) return Model::Rows;
+    std::cerr << "Ordre du front inconnu : " << name << " (insertion, morton ou rows)" << std::endl;
+    exit(EXIT_FAILURE);
+}
+
+void parse_checksum( std::string const& name, ParamsType& params )
+{
+    if (name == "off"s  ) { params.checksum = Verifier::Off;       return; }
+    if (name == "final"s) { params.checksum = Verifier::FinalOnly; return; }
+    if (name == "step"s ) { params.checksum = Verifier::Periodic; params.checksum_period = 1; return; }
+    std::size_t period = 0;
+    if (!name.empty() && (name.find_first_not_of("0123456789") == std::string::npos))
+        period = std::stoul(name);
+    if (period == 0)
+    {
+        std::cerr << "Cadence des empreintes inconnue : " << name << " (off, step, final ou N > 0)" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    params.checksum = Verifier::Periodic;
+    params.checksum_period = period;
+}
+
+Verifier::Method parse_digest( std::string const& name )
+{
+    if (name == "sha1"s       ) return Verifier::Sha1;
+    if (name == "incremental"s) return Verifier::Incremental;
+    std::cerr << "Empreinte inconnue : " << name << " (sha1 ou incremental)" << std::endl;
+    exit(EXIT_FAILURE);
+}
+
+void parse_render( std::string const& name, ParamsType& params )
+{
+    if (name == "sync"s) { params.render_thread = false; return; }
+    if (name == "drop"s) { params.render_thread = true; params.render_period = 1; return; }
+    std::size_t period = 0;
+    if (!name.empty() && (name.find_first_not_of("0123456789") == std::string::npos))
+        period = std::stoul(name);
+    if (period == 0)
+    {
+        std::cerr << "Mode d'affichage inconnu : " << name << " (drop, sync ou N > 0)" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    params.render_thread = true;
+    params.render_period = period;
+}
+
+void analyze_arg( int nargs, char* args[], ParamsType& params )
+{
+    if (nargs ==0) return;
+    std::string key(args[0]);
+    if (key == "-l"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque une valeur pour la longueur du terrain !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        params.length = std::stoul(args[1]);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    auto pos = key.find("--longueur=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key,pos+11);
+        params.length = std::stoul(subkey);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-n"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque une valeur pour le nombre de cases par direction pour la discrétisation du terrain !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        params.discretization = std::stoul(args[1]);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--number_of_cases=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+18);
+        params.discretization = std::stoul(subkey);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-w"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque une paire de valeurs pour la direction du vent !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        std::string values =std::string(args[1]);
+        params.wind[0] = std::stod(values);
+        auto pos = values.find(",");
+        if (pos == values.size())
+        {
+            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la vitesse" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        auto second_value = std::string(values, pos+1);
+        params.wind[1] = std::stod(second_value);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--wind=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+7);
+        params.wind[0] = std::stoul(subkey);
+        auto pos = subkey.find(",");
+        if (pos == subkey.size())
+        {
+            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la vitesse" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        auto second_value = std::string(subkey, pos+1);
+        params.wind[1] = std::stod(second_value);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-s"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque une paire de valeurs pour la position du foyer initial !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        std::string values =std::string(args[1]);
+        params.start.column = std::stod(values);
+        auto pos = values.find(",");
+        if (pos == values.size())
+        {
+            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la position du foyer initial" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        auto second_value = std::string(values, pos+1);
+        params.start.row = std::stod(second_value);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--start=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+8);
+        params.start.column = std::stoul(subkey);
+        auto pos = subkey.find(",");
+        if (pos == subkey.size())
+        {
+            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la vitesse" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        auto second_value = std::string(subkey, pos+1);
+        params.start.row = std::stod(second_value);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-v"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque la taille maximale de la fenêtre en pixels !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        params.viewport = std::stoul(args[1]);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--viewport=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+11);
+        params.viewport = std::stoul(subkey);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-r"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque le mode d'affichage (drop, sync ou N) !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        parse_render(args[1], params);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--render=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+9);
+        parse_render(subkey, params);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-k"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque le nom du parcours (scatter, gather ou auto) !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        params.kernel = parse_kernel(args[1]);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--kernel=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+9);
+        params.kernel = parse_kernel(subkey);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-o"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque l'ordre du front (insertion, morton ou rows) !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        params.order = parse_order(args[1]);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--order=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+8);
+        params.order = parse_order(subkey);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-x"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque une valeur pour la densité de bascule entre les parcours !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        params.crossover = std::stod(args[1]);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--crossover=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+12);
+        params.crossover = std::stod(subkey);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-c"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque la cadence des empreintes SHA-1 (off, step, final ou N) !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        parse_checksum(args[1], params);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--checksum=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+11);
+        parse_checksum(subkey, params);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-d"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque le type d'empreinte (sha1 ou incremental) !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        params.digest = parse_digest(args[1]);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--digest=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+9);
+        params.digest = parse_digest(subkey);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-a"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque le nombre de pas de temps calculés entre deux affichages !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        params.batch = std::stoul(args[1]);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--advance=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+10);
+        params.batch = std::stoul(subkey);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-m"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque le nom du journal de Merkle !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        params.merkle_log = args[1];
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--merkle=");
+    if (pos < key.size())
+    {
+        params.merkle_log = std::string(key, pos+9);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+}
+
+ParamsType parse_arguments( int nargs, char* args[] )
+{
+    if (nargs == 0) return {};
+    if ( (std::string(args[0]) == "--help"s) || (std::string(args[0]) == "-h") )
+    {
+        std::cout << 
+R"RAW(Usage : simulation [option(s)]
+  Lance la simulation d'incendie en prenant en compte les [option(s)].
+  Les options sont :
+    -l, --longueur=LONGUEUR     Définit la taille LONGUEUR (réel en km) du carré représentant la carte de la végétation.
+    -n, --number_of_cases=N     Nombre n de cases par direction pour la discrétisation
+    -w, --wind=VX,VY            Définit le vecteur vitesse du vent (pas de vent par défaut).
+    -s, --start=COL,ROW         Définit les indices I,J de la case où commence l'incendie (milieu de la carte par défaut)
+    -k, --kernel=PARCOURS       Parcours d'un pas de temps : scatter (depuis le front), gather (tuiles de 64 x 64 cases
+                                où une case est en feu, plus les bords des tuiles voisines qui les touchent) ou auto
+                                (choix à chaque pas selon la densité du front dans ces tuiles, par défaut)
+    -o, --order=ORDRE           Ordre de parcours du front par scatter : insertion (par défaut), ou à titre expérimental
+                                morton (trié le long d'une courbe de Morton à chaque pas) ou rows (trié ligne par
+                                ligne) ; aucun gain de temps mesuré pour ces deux ordres (voir bench_order)
+    -x, --crossover=DENSITE     Densité du front au-delà de laquelle auto choisit gather (mesurée au démarrage par défaut)
+    -c, --checksum=CADENCE      Empreintes des cartes : step (à chaque pas, par défaut), N (tous les N pas),
+                                final (état final seulement) ou off
+    -d, --digest=EMPREINTE      Empreinte affichée : sha1 (SHA-1 des cartes, par défaut) ou incremental (tenue à jour
+                                par le modèle, coût proportionnel au front)
+    -m, --merkle=FICHIER        Écrit à chaque pas l'arbre de Merkle des tuiles des cartes dans FICHIER (à comparer
+                                avec merkle_diff)
+    -a, --advance=K             Calcule K pas de temps d'affilée entre deux affichages (1 par défaut) ; empreintes et
+                                journal de Merkle ne sont alors faits qu'à la fin de chaque lot
+    -v, --viewport=PIXELS       Taille maximale de la fenêtre (1024 par défaut) : une carte plus grande y est montrée
+                                réduite ; touches + et - (zoom), flèches (déplacement), 0 (carte entière)
+    -r, --render=MODE           Affichage : drop (thread d'affichage qui montre le dernier état calculé, par défaut),
+                                N (idem, mais seul un lot sur N est proposé à l'affichage) ou sync (affichage après
+                                chaque lot, le calcul attend l'affichage)
+)RAW";
+        exit(EXIT_SUCCESS);
+    }
+    ParamsType params;
+    analyze_arg(nargs, args, params);
+    return params;
+}
+
+bool check_params(ParamsType& params)
+{
+    bool flag = true;
+    if (params.length <= 0)
+    {
+        std::cerr << "[ERREUR FATALE] La longueur du terrain doit être positive et non nulle !" << std::endl;
+        flag = false;
+    }
+
+    if (params.discretization <= 0)
+    {
+        std::cerr << "[ERREUR FATALE] Le nombre de cellules par direction doit être positive et non nulle !" << std::endl;
+        flag = false;
+    }
+
+    if (params.batch == 0)
+    {
+        std::cerr << "[ERREUR FATALE] Le nombre de pas de temps entre deux affichages doit être non nul !" << std::endl;
+        flag = false;
+    }
+
+    if (params.viewport == 0)
+    {
+        std::cerr << "[ERREUR FATALE] La taille de la fenêtre doit être non nulle !" << std::endl;
+        flag = false;
+    }
+
+    if ( (params.start.row >= params.discretization) || (params.start.column >= params.discretization) )
+    {
+        std::cerr << "[ERREUR FATALE] Mauvais indices pour la position initiale du foyer" << std::endl;
+        flag = false;
+    }
+    
+    return flag;
+}
+
+void display_params(ParamsType const& params)
+{
+    std::cout << "Parametres définis pour la simulation : \n"
+              << "\tTaille du terrain : " << params.length << std::endl 
+              << "\tNombre de cellules par direction : " << params.discretization << std::endl 
+              << "\tVecteur vitesse : [" << params.wind[0] << ", " << params.wind[1] << "]" << std::endl
+              << "\tPosition initiale du foyer (col, ligne) : " << params.start.column << ", " << params.start.row << std::endl
+              << "\tNoyau de tirage : " << front_kernel::name() << std::endl
+              << "\tParcours : " << (params.kernel == Model::Gather ? "gather" :
+                                      params.kernel == Model::Scatter ? "scatter" : "auto") << std::endl
+              << "\tOrdre du front : " << (params.order == Model::Morton ? "morton" :
+                                           params.order == Model::Rows ? "rows" : "insertion") << std::endl
+              << "\tEmpreintes " << (params.digest == Verifier::Sha1 ? "SHA-1"s : "incrémentales"s) << " : "
+              << (params.checksum == Verifier::Off ? "aucune"s :
+                  params.checksum == Verifier::FinalOnly ? "état final"s :
+                  "tous les "s + std::to_string(params.checksum_period) + " pas"s)
+              << std::endl
+              << "\tPas de temps entre deux affichages : " << params.batch << std::endl
+              << "\tTaille maximale de la fenêtre : " << params.viewport << std::endl
+              << "\tAffichage : " << (!params.render_thread ? "synchrone"s :
+                                      params.render_period == 1 ? "thread, dernier état calculé"s :
+                                      "thread, un lot sur "s + std::to_string(params.render_period)) << std::endl;
+}
+
+int main( int nargs, char* args[] )
+{
+    auto params = parse_arguments(nargs-1, &args[1]);
+    display_params(params);
+    if (!check_params(params)) return EXIT_FAILURE;
+
+    // Fenêtre de la taille de la carte, au plus viewport x viewport pixels (carte réduite au-delà)
+    unsigned window = std::min(params.discretization, params.viewport);
+    auto displayer = Displayer::init_instance( window, window );
+    auto simu = Model( params.length, params.discretization, params.wind,
+                       params.start);
+    simu.set_update_kernel(params.kernel);
+    simu.set_front_order(params.order);
+    simu.set_crossover(params.crossover);
+    simu.track_changes(true);
+    Verifier verifier(params.checksum, params.checksum_period, params.digest);
+    std::ofstream merkle_log;
+    if (!params.merkle_log.empty())
+    {
+        merkle_log.open(params.merkle_log);
+        if (!merkle_log)
+        {
+            std::cerr << "[ERREUR FATALE] Impossible de créer le journal " << params.merkle_log << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    std::size_t merkle_time_step = std::numeric_limits<std::size_t>::max();
+    auto log_merkle = [&]()
+    {
+        if (!merkle_log.is_open() || (simu.time_step() == merkle_time_step))
+            return;
+        unsigned nb_tiles = merkle::tiles_per_side(params.discretization);
+        std::vector<std::uint64_t> leaves(std::size_t(nb_tiles) * nb_tiles, 0u);
+        merkle::accumulate_leaves(simu.fire_view(), simu.vegetal_view(), params.discretization, 0, leaves);
+        merkle::write_step(merkle_log, simu.time_step(), params.discretization, leaves);
+        merkle_time_step = simu.time_step();
+    };
+    // Avec -a K, K pas de temps sont calculés d'affilée (Model::advance) : ni affichage ni événement entre eux
+    std::vector<Model::StepSummary> summaries;
+    auto advance = [&]()
+    {
+        if (params.batch == 1)
+            return simu.update();
+        summaries.clear();
+        return simu.advance(params.batch, summaries);
+    };
+    // Ce qui suit chaque lot de pas de temps, quel que soit le mode d'affichage
+    auto after_batch = [&]()
+    {
+        verifier.after_step(simu);
+        log_merkle();
+
+        // Un multiple de 32 parmi les pas du dernier lot
+        if ((simu.time_step() & 31) < params.batch)
+        {
+            std::cout << "Time step " << simu.time_step() << "\n===============" << std::endl;
+            // Le modèle n'écrit rien : parcours choisis par Adaptive depuis le début
+            if (params.kernel == Model::Adaptive)
+                std::cout << "Parcours : " << (simu.last_kernel() == Model::Gather ? "gather" : "scatter") << " ("
+                          << simu.kernel_steps(Model::Scatter) << " pas scatter, "
+                          << simu.kernel_steps(Model::Gather) << " pas gather)" << std::endl;
+        }
+    };
+    SDL_Event event;
+
+    std::chrono::duration<double> total_update_time{0};  
+    std::chrono::duration<double> total_display_time{0};  
+    std::chrono::duration<double> total_iteration_time{0};
+    int iteration_count = 0;
+    int image_count = 0;
+
+    if (!params.render_thread)
+    {
+        while (true)
+        {
+            auto start_iter = std::chrono::high_resolution_clock::now();
+
+            auto start_update = std::chrono::high_resolution_clock::now();
+            bool running = advance();
+            auto end_update = std::chrono::high_resolution_clock::now();
+            total_update_time += end_update - start_update;
+
+            if (!running) break;
+            after_batch();
+
+            auto start_display = std::chrono::high_resolution_clock::now();
+            // Seules les tuiles modifiées depuis l'affichage précédent sont redessinées
+            displayer->update(simu.vegetal_view(), simu.fire_view(), simu.changed_tiles());
+            simu.clear_changed_tiles();
+            auto end_display = std::chrono::high_resolution_clock::now();
+            total_display_time += end_display - start_display;
+
+            if (SDL_PollEvent(&event))
+            {
+                if (event.type == SDL_QUIT)
+                    break;
+                displayer->handle_event(event); // Zoom et déplacement
+            }
+
+            auto end_iter = std::chrono::high_resolution_clock::now();
+            total_iteration_time += end_iter - start_iter;
+            iteration_count++;
+        }
+        image_count = iteration_count;
+    }
+    else
+    {
+        // Le calcul tourne dans son propre thread et publie les cartes sans jamais attendre l'affichage ; SDL reste
+        // dans le thread principal, qui montre le dernier état publié (les états publiés entre-temps sont perdus).
+        // Le temps d'une itération est alors le temps total divisé par le nombre de lots calculés.
+        auto start_loop = std::chrono::high_resolution_clock::now();
+        SnapshotBuffer snapshots(params.discretization, params.discretization, simu.changed_tiles().tile_size());
+        std::atomic<bool> stop{false}, finished{false};
+        std::size_t published = 0;
+        std::thread computation([&]()
+        {
+            std::size_t published_step = std::numeric_limits<std::size_t>::max();
+            auto publish = [&]()
+            {
+                snapshots.publish(simu.time_step(), simu.vegetal_view(), simu.fire_view(), simu.changed_tiles());
+                simu.clear_changed_tiles();
+                ++published;
+                published_step = simu.time_step();
+            };
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                auto start_update = std::chrono::high_resolution_clock::now();
+                bool running = advance();
+                auto end_update = std::chrono::high_resolution_clock::now();
+                total_update_time += end_update - start_update;
+
+                if (!running) break;
+                after_batch();
+                if (++iteration_count % params.render_period == 0)
+                    publish();
+            }
+            // Le dernier état calculé, y compris celui du pas où le feu s'éteint, est toujours montré
+            if (simu.time_step() != published_step)
+                publish();
+            finished.store(true, std::memory_order_release);
+        });
+
+        std::vector<std::uint32_t> shown_versions; // Tuiles de l'image affichée (voir SnapshotBuffer::changes_since)
+        DirtyTiles redraw(params.discretization, params.discretization, simu.changed_tiles().tile_size());
+        while (true)
+        {
+            // Lu avant acquire : la dernière publication précède la fin du calcul
+            bool done = finished.load(std::memory_order_acquire);
+            if (snapshots.acquire())
+            {
+                auto start_display = std::chrono::high_resolution_clock::now();
+                auto const& snapshot = snapshots.front();
+                snapshots.changes_since(shown_versions, redraw);
+                displayer->update(snapshot.vegetation_view(), snapshot.fire_view(), redraw);
+                auto end_display = std::chrono::high_resolution_clock::now();
+                total_display_time += end_display - start_display;
+                image_count++;
+            }
+            else if (done)
+                break;
+            else
+                std::this_thread::sleep_for(1ms);
+            if (SDL_PollEvent(&event))
+            {
+                if (event.type == SDL_QUIT)
+                    stop.store(true, std::memory_order_relaxed);
+                else
+                    displayer->handle_event(event); // Zoom et déplacement
+            }
+        }
+        computation.join();
+        total_iteration_time = std::chrono::high_resolution_clock::now() - start_loop;
+        std::cout << "Images affichées : " << image_count << " sur " << published << " états publiés" << std::endl;
+    }
+
+    verifier.finish(simu);
+    log_merkle();
+    std::cout << "Dernier pas de temps : " << simu.time_step() << " (" << simu.burnt_cells()
+              << " cases touchées par le feu)" << std::endl;
+    if (iteration_count > 0) {
+        double mean_update_time = total_update_time.count() / iteration_count;
+        double mean_display_time = total_display_time.count() / std::max(image_count, 1);
+        double mean_iteration_time = total_iteration_time.count() / iteration_count;
+
+        std::cout << "Temps moyen pour chaque pas de temps (simu.update()): " 
+                  << mean_update_time << " seconds" << std::endl;
+        std::cout << "Temps moyen pour l'affichage (displayer->update()): " 
+                  << mean_display_time << " seconds" << std::endl;
+        std::cout << "Temps moyen pour chaque itération: " 
+                  << mean_iteration_time << " seconds" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
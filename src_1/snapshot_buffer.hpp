@@ -0,0 +1,128 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "dirty_tiles.hpp"
+#include "map_view.hpp"
+
+/**
+ * @brief Trois copies des cartes, échangées sans verrou entre le thread de calcul et le thread d'affichage.
+ *
+ * Le calcul écrit dans sa copie puis la publie en l'échangeant (atomiquement) avec la copie du milieu ; l'affichage
+ * prend la copie du milieu si elle a été publiée depuis. Aucun des deux n'attend l'autre : les états publiés entre
+ * deux affichages sont perdus et l'affichage montre toujours le dernier état publié.
+ *
+ * Chaque copie garde, par tuile, le numéro de la dernière publication qui a modifié la tuile. Une publication ne
+ * recopie donc que les tuiles changées depuis la dernière écriture de cette copie, et l'affichage en déduit les
+ * tuiles à redessiner depuis la copie qu'il a montrée, quel que soit le nombre d'états perdus entre les deux.
+ */
+class SnapshotBuffer
+{
+public:
+    struct Slot
+    {
+        std::size_t time_step = 0;
+        unsigned    rows = 0, columns = 0;
+        std::vector<std::uint8_t>  vegetation, fire;
+        std::vector<std::uint32_t> versions; // Numéro de publication de chaque tuile
+
+        MapView vegetation_view() const { return MapView(vegetation.data(), rows, columns, columns); }
+        MapView fire_view      () const { return MapView(fire.data(),       rows, columns, columns); }
+    };
+
+    SnapshotBuffer( unsigned t_rows, unsigned t_columns, unsigned t_tile_size )
+        :   m_tiles(t_rows, t_columns, t_tile_size),
+            m_versions(std::size_t(m_tiles.tile_rows()) * m_tiles.tile_columns(), 0u),
+            m_changed(m_versions.size(), 0u)
+    {
+        for (Slot& slot : m_slots)
+        {
+            slot.rows    = t_rows;
+            slot.columns = t_columns;
+            slot.vegetation.assign(std::size_t(t_rows) * t_columns, 0u);
+            slot.fire.assign(std::size_t(t_rows) * t_columns, 0u);
+            slot.versions.assign(m_versions.size(), 0u);
+        }
+    }
+
+    // Thread de calcul : publie l'état des cartes, t_changed_tiles contenant les tuiles modifiées depuis la
+    // publication précédente (toutes pour la première)
+    void publish( std::size_t t_time_step, MapView const & t_vegetation, MapView const & t_fire,
+                  DirtyTiles const & t_changed_tiles )
+    {
+        ++m_publication;
+        Slot& slot = m_slots[m_back];
+        for (unsigned tile_row = 0; tile_row < m_tiles.tile_rows(); ++tile_row)
+            for (unsigned tile_column = 0; tile_column < m_tiles.tile_columns(); ++tile_column)
+            {
+                std::size_t tile = std::size_t(tile_row) * m_tiles.tile_columns() + tile_column;
+                if (t_changed_tiles.dirty(tile_row, tile_column))
+                    m_versions[tile] = m_publication;
+                if (slot.versions[tile] == m_versions[tile])
+                    continue;
+                copy_tile(tile_row, tile_column, t_vegetation, slot.vegetation);
+                copy_tile(tile_row, tile_column, t_fire,       slot.fire);
+                slot.versions[tile] = m_versions[tile];
+            }
+        slot.time_step = t_time_step;
+        m_back = m_middle.exchange(m_back | fresh, std::memory_order_acq_rel) & ~fresh;
+    }
+
+    // Thread d'affichage : prend le dernier état publié s'il est nouveau (sinon faux, front() reste inchangé)
+    bool acquire()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & fresh) == 0)
+            return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & ~fresh;
+        return true;
+    }
+    Slot const & front() const { return m_slots[m_front]; }
+
+    // Thread d'affichage : tuiles de front() qui diffèrent de l'état décrit par t_versions (numéros de publication
+    // par tuile de l'état déjà affiché, tous nuls au départ), puis t_versions devient celui de front().
+    // N'alloue rien après le premier appel.
+    void changes_since( std::vector<std::uint32_t> & t_versions, DirtyTiles & t_changed_tiles )
+    {
+        Slot const& slot = front();
+        t_versions.resize(slot.versions.size(), 0u);
+        for (std::size_t tile = 0; tile < m_changed.size(); ++tile)
+            m_changed[tile] = std::uint8_t(slot.versions[tile] != t_versions[tile]);
+        t_changed_tiles.clear();
+        t_changed_tiles.merge(m_changed);
+        t_versions = slot.versions;
+    }
+
+private:
+    static constexpr unsigned fresh = 4u; // Bit de m_middle : copie publiée, pas encore prise par l'affichage
+
+    void copy_tile( unsigned t_tile_row, unsigned t_tile_column, MapView const & t_view,
+                    std::vector<std::uint8_t> & t_out ) const
+    {
+        unsigned row_begin    = t_tile_row * m_tiles.tile_size();
+        unsigned row_end      = std::min(row_begin + m_tiles.tile_size(), m_tiles.rows());
+        unsigned column_begin = t_tile_column * m_tiles.tile_size();
+        unsigned column_end   = std::min(column_begin + m_tiles.tile_size(), m_tiles.columns());
+        MapView tile = t_view.sub(row_begin, column_begin, row_end - row_begin, column_end - column_begin);
+        for (unsigned row = 0; row < tile.rows(); ++row)
+        {
+            std::uint8_t* out = t_out.data() + std::size_t(row_begin + row) * m_tiles.columns() + column_begin;
+            if (tile.bytes())
+                std::copy_n(tile.row(row), tile.columns(), out);
+            else
+                for (unsigned column = 0; column < tile.columns(); ++column)
+                    out[column] = tile(row, column);
+        }
+    }
+
+    DirtyTiles                 m_tiles;    // Découpage des cartes (son contenu ne sert pas)
+    std::vector<std::uint32_t> m_versions; // Thread de calcul : numéro de publication de chaque tuile
+    std::vector<std::uint8_t>  m_changed;  // Thread d'affichage : tuiles changées, tampon de changes_since()
+    std::uint32_t              m_publication = 0;
+    std::array<Slot, 3>        m_slots;
+    unsigned                   m_back  = 0;  // Copie du thread de calcul
+    unsigned                   m_front = 1;  // Copie du thread d'affichage
+    std::atomic<unsigned>      m_middle{2};  // Copie du milieu, avec le bit fresh
+};
@@ -0,0 +1,103 @@
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+#include "model.hpp"
+#include "snapshot_buffer.hpp"
+
+// Vérifie qu'un pas de temps n'alloue aucune mémoire. L'opérateur new global est remplacé par un compteur ; pour
+// chaque parcours (et chaque ordre du front en Scatter), une carte 2048 x 2048 fait un pas de mise en route
+// (calibrage d'Adaptive, premières publications des cartes) puis 1000 pas comptés, chacun publié dans un
+// SnapshotBuffer comme le fait le thread de calcul de simulation. Échoue si l'un des pas comptés alloue.
+namespace
+{
+    std::atomic<bool>        counting{false};
+    std::atomic<std::size_t> allocations{0};
+
+    void* allocate( std::size_t t_size )
+    {
+        if (counting.load(std::memory_order_relaxed))
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        if (void* pointer = std::malloc(t_size == 0 ? 1 : t_size))
+            return pointer;
+        throw std::bad_alloc();
+    }
+
+    void* allocate( std::size_t t_size, std::nothrow_t const & ) noexcept
+    {
+        try
+        {
+            return allocate(t_size);
+        }
+        catch (std::bad_alloc const &)
+        {
+            return nullptr;
+        }
+    }
+
+    constexpr unsigned    discretization = 2048;
+    constexpr std::size_t nb_steps       = 1000;
+
+    // Nombre d'allocations faites par les nb_steps pas qui suivent le pas de mise en route
+    std::size_t count_allocations( Model::UpdateKernel t_kernel, Model::FrontOrder t_order )
+    {
+        Model simu(1., discretization, {5., 5.}, {discretization / 2, discretization / 2});
+        simu.set_update_kernel(t_kernel);
+        simu.set_front_order(t_order);
+        SnapshotBuffer snapshots(discretization, discretization, simu.changed_tiles().tile_size());
+        DirtyTiles redraw(discretization, discretization, simu.changed_tiles().tile_size());
+        std::vector<std::uint32_t> shown_versions;
+        auto step = [&]()
+        {
+            bool running = simu.update();
+            snapshots.publish(simu.time_step(), simu.vegetal_view(), simu.fire_view(), simu.changed_tiles());
+            simu.clear_changed_tiles();
+            if (snapshots.acquire())
+                snapshots.changes_since(shown_versions, redraw);
+            return running;
+        };
+
+        step();
+        allocations = 0;
+        counting    = true;
+        for (std::size_t i = 0; (i < nb_steps) && step(); ++i)
+            ;
+        counting = false;
+        return allocations;
+    }
+}
+
+void* operator new  ( std::size_t t_size ) { return allocate(t_size); }
+void* operator new[]( std::size_t t_size ) { return allocate(t_size); }
+void* operator new  ( std::size_t t_size, std::nothrow_t const & t_tag ) noexcept { return allocate(t_size, t_tag); }
+void* operator new[]( std::size_t t_size, std::nothrow_t const & t_tag ) noexcept { return allocate(t_size, t_tag); }
+void operator delete  ( void* t_pointer ) noexcept { std::free(t_pointer); }
+void operator delete[]( void* t_pointer ) noexcept { std::free(t_pointer); }
+void operator delete  ( void* t_pointer, std::size_t ) noexcept { std::free(t_pointer); }
+void operator delete[]( void* t_pointer, std::size_t ) noexcept { std::free(t_pointer); }
+
+int main()
+{
+    struct Case
+    {
+        char const *        name;
+        Model::UpdateKernel kernel;
+        Model::FrontOrder   order;
+    };
+    Case const cases[] = {
+        {"Adaptive", Model::Adaptive, Model::Insertion},
+        {"Scatter",  Model::Scatter,  Model::Insertion},
+        {"Scatter (Morton)", Model::Scatter, Model::Morton},
+        {"Scatter (lignes)", Model::Scatter, Model::Rows},
+        {"Gather",   Model::Gather,   Model::Insertion}
+    };
+    bool failed = false;
+    for (Case const & c : cases)
+    {
+        std::size_t count = count_allocations(c.kernel, c.order);
+        std::cout << c.name << " : " << count << " allocation(s) en " << nb_steps << " pas de temps" << std::endl;
+        failed = failed || (count > 0);
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include "map_view.hpp"
+
+class Model;
+
+/**
+ * @brief Empreintes de l'état de la simulation.
+ *
+ * Sha1 : empreinte SHA-1 de la carte de feu puis de la carte de végétation (octets bruts). Après un pas de temps,
+ * after_step copie les deux cartes si une empreinte est due (Model::snapshot) et confie la copie à un thread de fond
+ * qui calcule et affiche l'empreinte : Model::update ne fait aucun hachage. Au plus max_pending copies attendent
+ * d'être hachées ; au-delà, after_step attend que le thread de fond en ait traité une.
+ * Incremental : empreinte tenue à jour par le modèle (Model::digest), affichée directement. Son coût suit la taille
+ * du front et non celle de la carte ; elle est la même pour toutes les versions de la simulation.
+ */
+class Verifier
+{
+public:
+    // Aucune empreinte, une tous les period pas de temps, ou seulement sur l'état final
+    enum Cadence { Off = 0, Periodic, FinalOnly };
+    enum Method  { Sha1 = 0, Incremental };
+
+    Verifier( Cadence t_cadence, std::size_t t_period = 1, Method t_method = Sha1 );
+    Verifier( Verifier const & ) = delete;
+    Verifier( Verifier      && ) = delete;
+    ~Verifier();
+
+    Verifier& operator = ( Verifier const & ) = delete;
+    Verifier& operator = ( Verifier      && ) = delete;
+
+    // À appeler après chaque Model::update
+    void after_step( Model const & t_model );
+    // Empreinte de l'état final (si la cadence le demande et qu'elle n'est pas déjà faite), puis attend le thread
+    // de fond : toutes les empreintes sont alors affichées.
+    void finish( Model const & t_model );
+
+    Cadence     cadence() const { return m_cadence; }
+    std::size_t period () const { return m_period;  }
+    Method      method () const { return m_method;  }
+
+private:
+    static constexpr std::size_t max_pending = 4;
+
+    void push( Model const & t_model );
+    void run();
+
+    Cadence     m_cadence;
+    std::size_t m_period;
+    Method      m_method;
+    std::size_t m_last_time_step = std::numeric_limits<std::size_t>::max(); // Pas de temps de la dernière copie
+
+    std::mutex              m_mutex;
+    std::condition_variable m_changed;
+    std::deque<MapSnapshot> m_pending;
+    bool                    m_stop = false;
+    std::thread             m_worker;
+};
@@ -1,86 +1,217 @@
-#include <cassert>
-#include <stdexcept>
-#include <string> 
-#include "display.hpp"
-
-using namespace std::string_literals;
-
-std::shared_ptr<Displayer> Displayer::unique_instance{nullptr};
-
-Displayer::Displayer( std::uint32_t t_width, std::uint32_t t_height )
-{
-    // Initialisation du contexte pour SDL :
-    // ----------------------------------------------------------------------------------------------------------------
-    // Puisqu'on a qu'une seule instance pour la fenêtre,
-    // on peut se permettre d'initialiser le contexte de
-    // SDL dans la création de la fenêtre à afficher !
-    if ( SDL_Init( SDL_INIT_EVERYTHING) < 0 )
-    {
-        std::string err_msg = "Erreur lors de l'initialisation de SDL : "s + std::string(SDL_GetError());
-        throw std::runtime_error(err_msg);
-    }
-    // Création de la fenêtre à afficher sur l'ecran (ainsi que le renderer associé):
-    // ----------------------------------------------------------------------------------------------------------------
-    SDL_CreateWindowAndRenderer(t_width, t_height, 0, &m_pt_window, &m_pt_renderer);
-    if (m_pt_window == nullptr) // On vérifie si la fenêtre a bien été créée
-    {
-        std::string err_msg = "Erreur lors de la création de la fenêtre : "s + std::string(SDL_GetError() );
-        throw std::runtime_error(err_msg);
-    }
-    if (m_pt_renderer == nullptr) // On vérifie si la fenêtre a bien été créée
-    {
-        std::string err_msg = "Erreur lors de la création du moteur de rendu : "s + std::string(SDL_GetError() );
-        throw std::runtime_error(err_msg);
-    }
-    // Récupération de la surface sur laquelle on va dessiner et afficher dans la fenêtre 
-    // ----------------------------------------------------------------------------------------------------------------
-    m_pt_surface = SDL_GetWindowSurface( m_pt_window );
-    if (m_pt_surface == nullptr) // On vérifie qu'on a bien récupéré la surface associée à la fenêtre
-    {
-        std::string err_msg = "Erreur lors de la récupération de la surface : "s + std::string(SDL_GetError() );
-        throw std::runtime_error(err_msg);
-    }
-}
-// ====================================================================================================================
-Displayer::~Displayer()
-{
-    // Destruction du moteur de rendu :
-    SDL_DestroyRenderer(m_pt_renderer);
-    // Destruction de la fenêtre ( et de la surface implicitement puisque associée à la fenêtre )
-    SDL_DestroyWindow( m_pt_window );
-    // On détruit également le contexte SDL
-    SDL_Quit();
-}
-// ====================================================================================================================
-void
-Displayer::update( std::vector<std::uint8_t> const & vegetation_global_map,
-                   std::vector<std::uint8_t> const & fire_global_map )
-{
-    int w, h;
-    SDL_GetWindowSize(m_pt_window, &w, &h );
-    SDL_SetRenderDrawColor(m_pt_renderer, 0,0,0, 255);
-    SDL_RenderClear(m_pt_renderer);
-    for (int i = 0; i < h; ++i )
-      for (int j =  0; j < w; ++j )
-      {
-        SDL_SetRenderDrawColor(m_pt_renderer, fire_global_map[j + w*i], vegetation_global_map[j + w*i], 0, 255);
-        SDL_RenderDrawPoint(m_pt_renderer, j, h-i-1); 
-      }
-    SDL_RenderPresent(m_pt_renderer);
-}
-// ####################################################################################################################
-//                      Définition des méthodes statiques associées au pattern singleton utilisé
-std::shared_ptr<Displayer> 
-Displayer::init_instance( std::uint32_t t_width, std::uint32_t t_height )
-{
-    assert( ( "L'initialisation de l'instance ne doit etre appele qu'une seule fois !" && (unique_instance == nullptr) ) );
-    unique_instance = std::make_shared<Displayer>(t_width, t_height);
-    return unique_instance;
-}
-// ====================================================================================================================
-std::shared_ptr<Displayer> 
-Displayer::instance()
-{
-    assert( ( "Il faut initialiser l'instance avant tout !" && (unique_instance != nullptr) ) );
-    return unique_instance;
-}
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <stdexcept>
+#include <string> 
+#include "display.hpp"
+
+using namespace std::string_literals;
+
+std::shared_ptr<Displayer> Displayer::unique_instance{nullptr};
+
+Displayer::Displayer( std::uint32_t t_width, std::uint32_t t_height )
+    :   m_frame(t_width, t_height), m_viewport(t_width, t_height)
+{
+    // Initialisation du contexte pour SDL :
+    // ----------------------------------------------------------------------------------------------------------------
+    // Puisqu'on a qu'une seule instance pour la fenêtre,
+    // on peut se permettre d'initialiser le contexte de
+    // SDL dans la création de la fenêtre à afficher !
+    if ( SDL_Init( SDL_INIT_EVERYTHING) < 0 )
+    {
+        std::string err_msg = "Erreur lors de l'initialisation de SDL : "s + std::string(SDL_GetError());
+        throw std::runtime_error(err_msg);
+    }
+    // Création de la fenêtre à afficher sur l'ecran (ainsi que le renderer associé):
+    // ----------------------------------------------------------------------------------------------------------------
+    SDL_CreateWindowAndRenderer(t_width, t_height, 0, &m_pt_window, &m_pt_renderer);
+    if (m_pt_window == nullptr) // On vérifie si la fenêtre a bien été créée
+    {
+        std::string err_msg = "Erreur lors de la création de la fenêtre : "s + std::string(SDL_GetError() );
+        throw std::runtime_error(err_msg);
+    }
+    if (m_pt_renderer == nullptr) // On vérifie si la fenêtre a bien été créée
+    {
+        std::string err_msg = "Erreur lors de la création du moteur de rendu : "s + std::string(SDL_GetError() );
+        throw std::runtime_error(err_msg);
+    }
+    // Récupération de la surface sur laquelle on va dessiner et afficher dans la fenêtre 
+    // ----------------------------------------------------------------------------------------------------------------
+    m_pt_surface = SDL_GetWindowSurface( m_pt_window );
+    if (m_pt_surface == nullptr) // On vérifie qu'on a bien récupéré la surface associée à la fenêtre
+    {
+        std::string err_msg = "Erreur lors de la récupération de la surface : "s + std::string(SDL_GetError() );
+        throw std::runtime_error(err_msg);
+    }
+    // Texture recevant l'image à chaque affichage (pas d'erreur si elle manque : tracé case par case)
+    // ----------------------------------------------------------------------------------------------------------------
+    char const* render = std::getenv("FIRE_RENDER");
+    if ( (render == nullptr) || (render != "points"s) )
+        m_pt_texture = SDL_CreateTexture(m_pt_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                         int(t_width), int(t_height));
+}
+// ====================================================================================================================
+Displayer::~Displayer()
+{
+    // Destruction de la texture et du moteur de rendu :
+    if (m_pt_texture != nullptr)
+        SDL_DestroyTexture(m_pt_texture);
+    SDL_DestroyRenderer(m_pt_renderer);
+    // Destruction de la fenêtre ( et de la surface implicitement puisque associée à la fenêtre )
+    SDL_DestroyWindow( m_pt_window );
+    // On détruit également le contexte SDL
+    SDL_Quit();
+}
+// ====================================================================================================================
+void
+Displayer::update( std::vector<std::uint8_t> const & vegetation_global_map,
+                   std::vector<std::uint8_t> const & fire_global_map )
+{
+    int w, h;
+    SDL_GetWindowSize(m_pt_window, &w, &h );
+    update(MapView(vegetation_global_map.data(), h, w, w), MapView(fire_global_map.data(), h, w, w));
+}
+// ====================================================================================================================
+void
+Displayer::update( MapView const & vegetation_global_map, MapView const & fire_global_map )
+{
+    m_viewport.set_map(fire_global_map.rows(), fire_global_map.columns());
+    m_pyramid.resize(fire_global_map.rows(), fire_global_map.columns(), m_viewport.fit_level());
+    m_pyramid.build(vegetation_global_map, fire_global_map);
+    m_pyramid_complete = true;
+    draw(vegetation_global_map, fire_global_map);
+}
+// ====================================================================================================================
+void
+Displayer::update( MapView const & vegetation_global_map, MapView const & fire_global_map,
+                   DirtyTiles const & changed_tiles )
+{
+    if ( !m_pyramid_complete || (m_pyramid.rows() != fire_global_map.rows()) ||
+         (m_pyramid.columns() != fire_global_map.columns()) )
+    {
+        update(vegetation_global_map, fire_global_map);
+        return;
+    }
+    m_pyramid.update(vegetation_global_map, fire_global_map, changed_tiles);
+    if ( (m_pt_texture == nullptr) || !m_frame_complete || !m_viewport.shows_whole_map() )
+    {
+        draw(vegetation_global_map, fire_global_map);
+        return;
+    }
+    m_frame.render(vegetation_global_map, fire_global_map, changed_tiles);
+    // Envoi des seules bandes modifiées (la ligne 0 des cartes est en bas de l'image)
+    for (unsigned tile_row = 0; tile_row < changed_tiles.tile_rows(); ++tile_row)
+        changed_tiles.for_each_span(tile_row, [this](unsigned row_begin, unsigned row_end,
+                                                     unsigned column_begin, unsigned column_end)
+        {
+            row_end    = std::min(row_end, m_frame.height());
+            column_end = std::min(column_end, m_frame.width());
+            if ( (row_begin >= row_end) || (column_begin >= column_end) )
+                return;
+            SDL_Rect rectangle{int(column_begin), int(m_frame.height() - row_end),
+                               int(column_end - column_begin), int(row_end - row_begin)};
+            SDL_UpdateTexture(m_pt_texture, &rectangle,
+                              m_frame.pixels() + std::size_t(rectangle.y) * m_frame.width() + column_begin,
+                              int(m_frame.pitch()));
+        });
+    SDL_RenderCopy(m_pt_renderer, m_pt_texture, nullptr, nullptr);
+    SDL_RenderPresent(m_pt_renderer);
+}
+// ====================================================================================================================
+void
+Displayer::update( lod::Region const & region, MapView const & vegetation_region, MapView const & fire_region )
+{
+    if (m_pt_texture == nullptr)
+    {
+        draw_points(vegetation_region, fire_region);
+        return;
+    }
+    m_frame.render(vegetation_region, fire_region);
+    m_frame_complete = m_viewport.shows_whole_map();
+    // L'image de la région occupe le bas à gauche du tampon (la ligne 0 des cartes est en bas) : seule cette partie
+    // est envoyée, puis agrandie à la fenêtre en gardant ses proportions
+    int rows    = int(std::min(region.rows, m_frame.height()));
+    int columns = int(std::min(region.columns, m_frame.width()));
+    SDL_Rect source{0, int(m_frame.height()) - rows, columns, rows};
+    SDL_UpdateTexture(m_pt_texture, &source, m_frame.pixels() + std::size_t(source.y) * m_frame.width(),
+                      int(m_frame.pitch()));
+    double scale = std::min(double(m_frame.width()) / columns, double(m_frame.height()) / rows);
+    int target_width = int(columns * scale), target_height = int(rows * scale);
+    SDL_Rect target{(int(m_frame.width()) - target_width) / 2, (int(m_frame.height()) - target_height) / 2,
+                    target_width, target_height};
+    SDL_SetRenderDrawColor(m_pt_renderer, 0, 0, 0, 255);
+    SDL_RenderClear(m_pt_renderer);
+    SDL_RenderCopy(m_pt_renderer, m_pt_texture, &source, &target);
+    SDL_RenderPresent(m_pt_renderer);
+}
+// ====================================================================================================================
+bool
+Displayer::handle_event( SDL_Event const & event )
+{
+    if (event.type != SDL_KEYDOWN)
+        return false;
+    switch (event.key.keysym.sym)
+    {
+    case SDLK_PLUS: case SDLK_KP_PLUS: case SDLK_EQUALS:
+        m_viewport.zoom_in();
+        break;
+    case SDLK_MINUS: case SDLK_KP_MINUS:
+        m_viewport.zoom_out();
+        break;
+    case SDLK_UP:    m_viewport.pan( 1,  0); break;
+    case SDLK_DOWN:  m_viewport.pan(-1,  0); break;
+    case SDLK_RIGHT: m_viewport.pan( 0,  1); break;
+    case SDLK_LEFT:  m_viewport.pan( 0, -1); break;
+    case SDLK_0: case SDLK_HOME:
+        m_viewport.reset();
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+// ====================================================================================================================
+// Partie visible du niveau choisi par le zoom : le niveau 0 est lu directement dans les cartes
+void
+Displayer::draw( MapView const & vegetation_global_map, MapView const & fire_global_map )
+{
+    lod::Region region = m_viewport.region();
+    MapView vegetation = (region.level == 0 ? vegetation_global_map : m_pyramid.vegetation(region.level));
+    MapView fire       = (region.level == 0 ? fire_global_map       : m_pyramid.fire(region.level));
+    update(region, vegetation.sub(region.first_row, region.first_column, region.rows, region.columns),
+           fire.sub(region.first_row, region.first_column, region.rows, region.columns));
+}
+// ====================================================================================================================
+void
+Displayer::draw_points( MapView const & vegetation_global_map, MapView const & fire_global_map )
+{
+    int w, h;
+    SDL_GetWindowSize(m_pt_window, &w, &h );
+    h = std::min(h, int(fire_global_map.rows()));
+    w = std::min(w, int(fire_global_map.columns()));
+    SDL_SetRenderDrawColor(m_pt_renderer, 0,0,0, 255);
+    SDL_RenderClear(m_pt_renderer);
+    for (int i = 0; i < h; ++i )
+      for (int j =  0; j < w; ++j )
+      {
+        SDL_SetRenderDrawColor(m_pt_renderer, fire_global_map(i, j), vegetation_global_map(i, j), 0, 255);
+        SDL_RenderDrawPoint(m_pt_renderer, j, h-i-1); 
+      }
+    SDL_RenderPresent(m_pt_renderer);
+}
+// ####################################################################################################################
+//                      Définition des méthodes statiques associées au pattern singleton utilisé
+std::shared_ptr<Displayer> 
+Displayer::init_instance( std::uint32_t t_width, std::uint32_t t_height )
+{
+    assert( ( "L'initialisation de l'instance ne doit etre appele qu'une seule fois !" && (unique_instance == nullptr) ) );
+    unique_instance = std::make_shared<Displayer>(t_width, t_height);
+    return unique_instance;
+}
+// ====================================================================================================================
+std::shared_ptr<Displayer> 
+Displayer::instance()
+{
+    assert( ( "Il faut initialiser l'instance avant tout !" && (unique_instance != nullptr) ) );
+    return unique_instance;
+}
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include "lod.hpp"
+
+namespace
+{
+    // Cases [t_row_begin, t_row_end) x [t_column_begin, t_column_end) d'un niveau (t_vegetation, t_fire, t_columns
+    // cases par ligne), à partir du niveau précédent
+    void reduce( MapView const & t_source_vegetation, MapView const & t_source_fire, unsigned t_row_begin,
+                 unsigned t_row_end, unsigned t_column_begin, unsigned t_column_end, std::uint8_t * t_vegetation,
+                 std::uint8_t * t_fire, unsigned t_columns )
+    {
+        unsigned source_begin = 2 * t_column_begin;
+        unsigned source_end   = std::min(2 * t_column_end, t_source_fire.columns());
+        for (unsigned row = t_row_begin; row < t_row_end; ++row)
+        {
+            unsigned bottom = 2 * row, top = std::min(bottom + 1, t_source_fire.rows() - 1);
+            auto v0 = t_source_vegetation.row(bottom) + source_begin, f0 = t_source_fire.row(bottom) + source_begin;
+            auto v1 = t_source_vegetation.row(top)    + source_begin, f1 = t_source_fire.row(top)    + source_begin;
+            std::size_t out = std::size_t(row) * t_columns;
+            for (unsigned column = t_column_begin; column < t_column_end; ++column)
+            {
+                unsigned left = 2 * column - source_begin, right = std::min(left + 1, source_end - source_begin - 1);
+                t_fire[out + column] = std::max({f0[left], f0[right], f1[left], f1[right]});
+                t_vegetation[out + column] = std::uint8_t((unsigned(v0[left]) + v0[right] + v1[left] + v1[right] + 2)
+                                                          / 4);
+            }
+        }
+    }
+
+    // Toutes les cases d'un niveau de t_rows x t_columns cases
+    void reduce_all( MapView const & t_source_vegetation, MapView const & t_source_fire, unsigned t_rows,
+                     unsigned t_columns, std::uint8_t * t_vegetation, std::uint8_t * t_fire )
+    {
+        reduce(t_source_vegetation, t_source_fire, 0, t_rows, 0, t_columns, t_vegetation, t_fire, t_columns);
+    }
+}
+// ====================================================================================================================
+void
+lod::accumulate( MapView const & t_vegetation, MapView const & t_fire, unsigned t_first_row, Region const & t_region,
+                 std::uint32_t * t_vegetation_sums, std::uint8_t * t_fire_max )
+{
+    unsigned level        = t_region.level;
+    unsigned row_begin    = std::max(t_first_row, t_region.first_row << level);
+    unsigned row_end      = std::min(t_first_row + t_fire.rows(), (t_region.first_row + t_region.rows) << level);
+    unsigned column_begin = t_region.first_column << level;
+    unsigned column_end   = std::min(t_fire.columns(), (t_region.first_column + t_region.columns) << level);
+    if ( (row_begin >= row_end) || (column_begin >= column_end) )
+        return;
+    for (unsigned row = row_begin; row < row_end; ++row)
+    {
+        std::size_t  out = std::size_t((row >> level) - t_region.first_row) * t_region.columns;
+        auto vegetation = t_vegetation.row(row - t_first_row), fire = t_fire.row(row - t_first_row);
+        for (unsigned column = column_begin; column < column_end; ++column)
+        {
+            std::size_t cell = out + (column >> level) - t_region.first_column;
+            t_vegetation_sums[cell] += vegetation[column];
+            t_fire_max[cell] = std::max(t_fire_max[cell], fire[column]);
+        }
+    }
+}
+// --------------------------------------------------------------------------------------------------------------------
+void
+lod::average( Region const & t_region, unsigned t_rows, unsigned t_columns,
+              std::uint32_t const * t_vegetation_sums, std::uint8_t * t_vegetation )
+{
+    unsigned level = t_region.level;
+    // Nombre de cases de la carte dans la case t_index du niveau (moins de 2^level sur le dernier bloc)
+    auto extent = [level](unsigned t_index, unsigned t_size)
+    {
+        return std::min((t_index + 1) << level, t_size) - (t_index << level);
+    };
+    for (unsigned row = 0; row < t_region.rows; ++row)
+    {
+        std::uint32_t height = extent(t_region.first_row + row, t_rows);
+        for (unsigned column = 0; column < t_region.columns; ++column)
+        {
+            std::uint32_t count = height * extent(t_region.first_column + column, t_columns);
+            std::size_t   cell  = std::size_t(row) * t_region.columns + column;
+            t_vegetation[cell] = std::uint8_t((t_vegetation_sums[cell] + count / 2) / count);
+        }
+    }
+}
+// ####################################################################################################################
+Viewport::Viewport( unsigned t_width, unsigned t_height )
+    :   m_width(t_width), m_height(t_height)
+{}
+// --------------------------------------------------------------------------------------------------------------------
+void
+Viewport::set_map( unsigned t_rows, unsigned t_columns )
+{
+    if ( (t_rows == m_rows) && (t_columns == m_columns) )
+        return;
+    m_rows    = t_rows;
+    m_columns = t_columns;
+    m_fit_level = 0;
+    while ( (m_fit_level < lod::max_level) && ( (lod::level_size(m_rows, m_fit_level) > m_height) ||
+                                                (lod::level_size(m_columns, m_fit_level) > m_width) ) )
+        ++m_fit_level;
+    reset();
+}
+// --------------------------------------------------------------------------------------------------------------------
+lod::Region
+Viewport::region() const
+{
+    unsigned level   = unsigned(std::max(m_zoom, 0));
+    unsigned shrink  = unsigned(std::max(-m_zoom, 0));
+    unsigned rows    = std::min(lod::level_size(m_rows, level),    std::max(m_height >> shrink, 1u));
+    unsigned columns = std::min(lod::level_size(m_columns, level), std::max(m_width  >> shrink, 1u));
+    // Première case d'une partie de t_count cases autour du centre, sans sortir du niveau
+    auto first = [level](unsigned t_center, unsigned t_count, unsigned t_size)
+    {
+        unsigned center = t_center >> level;
+        return std::min(center - std::min(center, t_count / 2), lod::level_size(t_size, level) - t_count);
+    };
+    return { level, first(m_center_row, rows, m_rows), first(m_center_column, columns, m_columns), rows, columns };
+}
+// --------------------------------------------------------------------------------------------------------------------
+bool
+Viewport::shows_whole_map() const
+{
+    lod::Region visible = region();
+    return (visible.level == 0) && (visible.rows == m_rows) && (visible.columns == m_columns) &&
+           (m_rows == m_height) && (m_columns == m_width);
+}
+// --------------------------------------------------------------------------------------------------------------------
+void
+Viewport::zoom_in()
+{
+    m_zoom = std::max(m_zoom - 1, -max_magnification);
+}
+// --------------------------------------------------------------------------------------------------------------------
+void
+Viewport::zoom_out()
+{
+    m_zoom = std::min(m_zoom + 1, int(m_fit_level));
+}
+// --------------------------------------------------------------------------------------------------------------------
+void
+Viewport::pan( int t_rows, int t_columns )
+{
+    lod::Region visible = region();
+    auto move = [&visible](unsigned t_center, int t_quarters, unsigned t_count, unsigned t_size)
+    {
+        long step   = std::max(long(t_count << visible.level) / 4, 1L);
+        long center = long(t_center) + t_quarters * step;
+        return unsigned(std::clamp(center, 0L, long(t_size) - 1));
+    };
+    m_center_row    = move(m_center_row,    t_rows,    visible.rows,    m_rows);
+    m_center_column = move(m_center_column, t_columns, visible.columns, m_columns);
+}
+// --------------------------------------------------------------------------------------------------------------------
+void
+Viewport::reset()
+{
+    m_zoom = int(m_fit_level);
+    m_center_row    = m_rows / 2;
+    m_center_column = m_columns / 2;
+}
+// --------------------------------------------------------------------------------------------------------------------
+void
+Viewport::set_state( State const & t_state )
+{
+    m_zoom = std::clamp(t_state[0], -max_magnification, int(m_fit_level));
+    m_center_row    = unsigned(std::clamp(t_state[1], 0, std::max(int(m_rows) - 1, 0)));
+    m_center_column = unsigned(std::clamp(t_state[2], 0, std::max(int(m_columns) - 1, 0)));
+}
+// ####################################################################################################################
+void
+Pyramid::resize( unsigned t_rows, unsigned t_columns, unsigned t_top_level )
+{
+    if ( (t_rows == m_rows) && (t_columns == m_columns) && (t_top_level == top_level()) )
+        return;
+    m_rows    = t_rows;
+    m_columns = t_columns;
+    m_levels.resize(t_top_level);
+    for (unsigned level = 1; level <= t_top_level; ++level)
+    {
+        Level& current = m_levels[level - 1];
+        current.rows    = lod::level_size(t_rows, level);
+        current.columns = lod::level_size(t_columns, level);
+        current.vegetation.assign(std::size_t(current.rows) * current.columns, 0u);
+        current.fire.assign(std::size_t(current.rows) * current.columns, 0u);
+    }
+}
+// --------------------------------------------------------------------------------------------------------------------
+void
+Pyramid::build( MapView const & t_vegetation, MapView const & t_fire )
+{
+    for (unsigned level = 1; level <= top_level(); ++level)
+    {
+        Level& current = m_levels[level - 1];
+        MapView source_vegetation = (level == 1 ? t_vegetation : vegetation(level - 1));
+        MapView source_fire       = (level == 1 ? t_fire       : fire(level - 1));
+        reduce_all(source_vegetation, source_fire, current.rows, current.columns, current.vegetation.data(),
+                   current.fire.data());
+    }
+}
+// --------------------------------------------------------------------------------------------------------------------
+void
+Pyramid::update( MapView const & t_vegetation, MapView const & t_fire, DirtyTiles const & t_tiles )
+{
+    for (unsigned level = 1; level <= top_level(); ++level)
+    {
+        Level& current = m_levels[level - 1];
+        MapView source_vegetation = (level == 1 ? t_vegetation : vegetation(level - 1));
+        MapView source_fire       = (level == 1 ? t_fire       : fire(level - 1));
+        // Une case du niveau couvre plus d'une tuile : le niveau, petit, est recalculé en entier
+        if (t_tiles.tile_size() % (1u << level) != 0)
+        {
+            reduce_all(source_vegetation, source_fire, current.rows, current.columns, current.vegetation.data(),
+                       current.fire.data());
+            continue;
+        }
+        for (unsigned tile_row = 0; tile_row < t_tiles.tile_rows(); ++tile_row)
+            t_tiles.for_each_span(tile_row, [&](unsigned t_row_begin, unsigned t_row_end,
+                                                unsigned t_column_begin, unsigned t_column_end)
+            {
+                reduce(source_vegetation, source_fire, t_row_begin >> level,
+                       std::min(((t_row_end - 1) >> level) + 1, current.rows), t_column_begin >> level,
+                       std::min(((t_column_end - 1) >> level) + 1, current.columns), current.vegetation.data(),
+                       current.fire.data(), current.columns);
+            });
+    }
+}
+// --------------------------------------------------------------------------------------------------------------------
+MapView
+Pyramid::vegetation( unsigned t_level ) const
+{
+    Level const& current = m_levels[t_level - 1];
+    return MapView(current.vegetation.data(), current.rows, current.columns, current.columns);
+}
+// --------------------------------------------------------------------------------------------------------------------
+MapView
+Pyramid::fire( unsigned t_level ) const
+{
+    Level const& current = m_levels[t_level - 1];
+    return MapView(current.fire.data(), current.rows, current.columns, current.columns);
+}
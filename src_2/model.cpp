@@ -1,181 +1,263 @@
-#include <stdexcept>
-#include <cmath>
-#include <iostream>
-#include "model.hpp"
-
-
-namespace
-{
-    double pseudo_random( std::size_t index, std::size_t time_step )
-    {
-        std::uint_fast32_t xi = std::uint_fast32_t(index*(time_step+1));
-        std::uint_fast32_t r  = (48271*xi)%2147483647;
-        return r/2147483646.;
-    }
-
-    double log_factor( std::uint8_t value )
-    {
-        return std::log(1.+value)/std::log(256);
-    }
-}
-
-Model::Model( double t_length, unsigned t_discretization, std::array<double,2> t_wind,
-              LexicoIndices t_start_fire_position, double t_max_wind )
-    :   m_length(t_length),
-        m_distance(-1),
-        m_geometry(t_discretization),
-        m_wind(t_wind),
-        m_wind_speed(std::sqrt(t_wind[0]*t_wind[0] + t_wind[1]*t_wind[1])),
-        m_max_wind(t_max_wind),
-        m_vegetation_map(t_discretization*t_discretization, 255u),
-        m_fire_map(t_discretization*t_discretization, 0u)
-{
-    if (t_discretization == 0)
-    {
-        throw std::range_error("Le nombre de cases par direction doit être plus grand que zéro.");
-    }
-    m_distance = m_length/double(m_geometry);
-    auto index = get_index_from_lexicographic_indices(t_start_fire_position);
-    m_fire_map[index] = 255u;
-    m_fire_front[index] = 255u;
-
-    constexpr double alpha0 = 4.52790762e-01;
-    constexpr double alpha1 = 9.58264437e-04;
-    constexpr double alpha2 = 3.61499382e-05;
-
-    if (m_wind_speed < t_max_wind)
-        p1 = alpha0 + alpha1*m_wind_speed + alpha2*(m_wind_speed*m_wind_speed);
-    else 
-        p1 = alpha0 + alpha1*t_max_wind + alpha2*(t_max_wind*t_max_wind);
-    p2 = 0.3;
-
-    if (m_wind[0] > 0)
-    {
-        alphaEastWest = std::abs(m_wind[0]/t_max_wind)+1;
-        alphaWestEast = 1.-std::abs(m_wind[0]/t_max_wind);    
-    }
-    else
-    {
-        alphaWestEast = std::abs(m_wind[0]/t_max_wind)+1;
-        alphaEastWest = 1. - std::abs(m_wind[0]/t_max_wind);
-    }
-
-    if (m_wind[1] > 0)
-    {
-        alphaSouthNorth = std::abs(m_wind[1]/t_max_wind) + 1;
-        alphaNorthSouth = 1. - std::abs(m_wind[1]/t_max_wind);
-    }
-    else
-    {
-        alphaNorthSouth = std::abs(m_wind[1]/t_max_wind) + 1;
-        alphaSouthNorth = 1. - std::abs(m_wind[1]/t_max_wind);
-    }
-}
-// --------------------------------------------------------------------------------------------------------------------
-bool 
-Model::update()
-{
-    auto next_front = m_fire_front;
-    for (auto f : m_fire_front)
-    {
-        // Récupération de la coordonnée lexicographique de la case en feu :
-        LexicoIndices coord = get_lexicographic_from_index(f.first);
-        // Et de la puissance du foyer
-        double        power = log_factor(f.second);
-
-
-        // On va tester les cases voisines pour contamination par le feu :
-        if (coord.row < m_geometry-1)
-        {
-            double tirage      = pseudo_random( f.first+m_time_step, m_time_step);
-            double green_power = m_vegetation_map[f.first+m_geometry];
-            double correction  = power*log_factor(green_power);
-            if (tirage < alphaSouthNorth*p1*correction)
-            {
-                m_fire_map[f.first + m_geometry]   = 255.;
-                next_front[f.first + m_geometry] = 255.;
-            }
-        }
-
-        if (coord.row > 0)
-        {
-            double tirage      = pseudo_random( f.first*13427+m_time_step, m_time_step);
-            double green_power = m_vegetation_map[f.first - m_geometry];
-            double correction  = power*log_factor(green_power);
-            if (tirage < alphaNorthSouth*p1*correction)
-            {
-                m_fire_map[f.first - m_geometry] = 255.;
-                next_front[f.first - m_geometry] = 255.;
-            }
-        }
-
-        if (coord.column < m_geometry-1)
-        {
-            double tirage      = pseudo_random( f.first*13427*13427+m_time_step, m_time_step);
-            double green_power = m_vegetation_map[f.first+1];
-            double correction  = power*log_factor(green_power);
-            if (tirage < alphaEastWest*p1*correction)
-            {
-                m_fire_map[f.first + 1] = 255.;
-                next_front[f.first + 1] = 255.;
-            }
-        }
-
-        if (coord.column > 0)
-        {
-            double tirage      = pseudo_random( f.first*13427*13427*13427+m_time_step, m_time_step);
-            double green_power = m_vegetation_map[f.first - 1];
-            double correction  = power*log_factor(green_power);
-            if (tirage < alphaWestEast*p1*correction)
-            {
-                m_fire_map[f.first - 1] = 255.;
-                next_front[f.first - 1] = 255.;
-            }
-        }
-        // Si le feu est à son max,
-        if (f.second == 255)
-        {   // On regarde si il commence à faiblir pour s'éteindre au bout d'un moment :
-            double tirage = pseudo_random( f.first * 52513 + m_time_step, m_time_step);
-            if (tirage < p2)
-            {
-                m_fire_map[f.first] >>= 1;
-                next_front[f.first] >>= 1;
-            }
-        }
-        else
-        {
-            // Foyer en train de s'éteindre.
-            m_fire_map[f.first] >>= 1;
-            next_front[f.first] >>= 1;
-            if (next_front[f.first] == 0)
-            {
-                next_front.erase(f.first);
-            }
-        }
-
-    }    
-    // A chaque itération, la végétation à l'endroit d'un foyer diminue
-    m_fire_front = next_front;
-    for (auto f : m_fire_front)
-    {
-        if (m_vegetation_map[f.first] > 0)
-            m_vegetation_map[f.first] -= 1;
-    }
-    m_time_step += 1;
-    return !m_fire_front.empty();
-}
-// ====================================================================================================================
-std::size_t   
-Model::get_index_from_lexicographic_indices( LexicoIndices t_lexico_indices  ) const
-{
-    return t_lexico_indices.row*this->geometry() + t_lexico_indices.column;
-}
-// --------------------------------------------------------------------------------------------------------------------
-auto 
-Model::get_lexicographic_from_index( std::size_t t_global_index ) const -> LexicoIndices
-{
-    LexicoIndices ind_coords;
-    ind_coords.row    = t_global_index/this->geometry();
-    ind_coords.column = t_global_index%this->geometry();
-    return ind_coords;
-}
+#include <stdexcept>
+#include <cmath>
+#include <iostream>
+#include "model.hpp"
+
+
+namespace
+{
+    std::uint_fast32_t pseudo_random_raw( std::size_t index, std::size_t time_step )
+    {
+        std::uint_fast32_t xi = std::uint_fast32_t(index*(time_step+1));
+        return (48271*xi)%2147483647;
+    }
+
+    [[maybe_unused]] double pseudo_random( std::size_t index, std::size_t time_step )
+    {
+        return pseudo_random_raw(index, time_step)/2147483646.;
+    }
+
+    double log_factor( std::uint8_t value )
+    {
+        return std::log(1.+value)/std::log(256);
+    }
+
+    // Plus petit tirage brut r tel que r/2147483646. >= probability : le test flottant
+    // "pseudo_random(...) < probability" est alors exactement "pseudo_random_raw(...) < seuil".
+    std::uint32_t raw_threshold( double probability )
+    {
+        if (!(probability > 0.))
+            return 0u;
+        if (probability > 1.)
+            return 2147483647u;
+        std::uint64_t r = std::uint64_t(probability*2147483646.);
+        while ((r > 0) && ((r-1)/2147483646. >= probability))
+            --r;
+        while ((r <= 2147483646u) && (r/2147483646. < probability))
+            ++r;
+        return std::uint32_t(r);
+    }
+}
+
+Model::Model( double t_length, unsigned t_discretization, std::array<double,2> t_wind,
+              LexicoIndices t_start_fire_position, double t_max_wind )
+    :   m_length(t_length),
+        m_distance(-1),
+        m_geometry(t_discretization),
+        m_wind(t_wind),
+        m_wind_speed(std::sqrt(t_wind[0]*t_wind[0] + t_wind[1]*t_wind[1])),
+        m_max_wind(t_max_wind),
+        m_vegetation_map(t_discretization*t_discretization, 255u),
+        m_fire_map(t_discretization*t_discretization, 0u),
+        m_exhausted_neighbours(t_discretization*t_discretization, 0u),
+        m_fire_front(t_discretization*t_discretization),
+        m_next_front(t_discretization*t_discretization)
+{
+    if (t_discretization == 0)
+    {
+        throw std::range_error("Le nombre de cases par direction doit être plus grand que zéro.");
+    }
+    m_distance = m_length/double(m_geometry);
+    // Les cases du bord de la carte ont un voisin en dehors
+    for (std::size_t i = 0; i < m_geometry; ++i)
+    {
+        m_exhausted_neighbours[i]                             |= 1u << NorthSouth;
+        m_exhausted_neighbours[(m_geometry-1)*m_geometry + i] |= 1u << SouthNorth;
+        m_exhausted_neighbours[i*m_geometry]                  |= 1u << WestEast;
+        m_exhausted_neighbours[i*m_geometry + m_geometry-1]   |= 1u << EastWest;
+    }
+    auto index = get_index_from_lexicographic_indices(t_start_fire_position);
+    m_fire_map[index] = 255u;
+    m_fire_front.set(index, 255u);
+
+    constexpr double alpha0 = 4.52790762e-01;
+    constexpr double alpha1 = 9.58264437e-04;
+    constexpr double alpha2 = 3.61499382e-05;
+
+    if (m_wind_speed < t_max_wind)
+        p1 = alpha0 + alpha1*m_wind_speed + alpha2*(m_wind_speed*m_wind_speed);
+    else 
+        p1 = alpha0 + alpha1*t_max_wind + alpha2*(t_max_wind*t_max_wind);
+    p2 = 0.3;
+
+    if (m_wind[0] > 0)
+    {
+        alphaEastWest = std::abs(m_wind[0]/t_max_wind)+1;
+        alphaWestEast = 1.-std::abs(m_wind[0]/t_max_wind);    
+    }
+    else
+    {
+        alphaWestEast = std::abs(m_wind[0]/t_max_wind)+1;
+        alphaEastWest = 1. - std::abs(m_wind[0]/t_max_wind);
+    }
+
+    if (m_wind[1] > 0)
+    {
+        alphaSouthNorth = std::abs(m_wind[1]/t_max_wind) + 1;
+        alphaNorthSouth = 1. - std::abs(m_wind[1]/t_max_wind);
+    }
+    else
+    {
+        alphaNorthSouth = std::abs(m_wind[1]/t_max_wind) + 1;
+        alphaSouthNorth = 1. - std::abs(m_wind[1]/t_max_wind);
+    }
+
+    // Tables des seuils entiers pour le test d'allumage et l'affaiblissement des foyers
+    m_ignition_thresholds.resize(4*256*256);
+    for (Direction direction : {SouthNorth, NorthSouth, EastWest, WestEast})
+        for (unsigned power = 0; power < 256; ++power)
+            for (unsigned green_power = 0; green_power < 256; ++green_power)
+            {
+                double correction = log_factor(power)*log_factor(green_power);
+                m_ignition_thresholds[(direction*256 + power)*256 + green_power] =
+                    raw_threshold(alpha(direction)*p1*correction);
+            }
+    m_extinction_threshold = raw_threshold(p2);
+}
+// --------------------------------------------------------------------------------------------------------------------
+bool 
+Model::update()
+{
+    // Le front du pas suivant est reconstruit dans le second tampon puis échangé avec le front courant.
+    // Une case allumée par un voisin au cours du pas repart à 255 quel que soit l'ordre de parcours.
+    // Toute case du front suivant perd une unité de végétation. Une case y entrant à 255 la perd dès son écriture :
+    // un voisin traité plus tard ne lit plus sa végétation que pour la rallumer, ce qui ne change rien. Un foyer
+    // affaibli peut encore être rallumé par un voisin (le tirage dépend de sa végétation) : il n'est consommé
+    // qu'en fin de parcours, ou dès qu'il est rallumé.
+    m_next_front.clear();
+    m_processed_cells += m_fire_front.size();
+    for (std::size_t i = 0; i < m_fire_front.size(); ++i)
+    {
+        std::size_t f = m_fire_front.index(i);
+        // Voisins hors de la carte ou sans végétation : ils ne peuvent pas s'allumer, aucun tirage
+        std::uint8_t  exhausted = m_exhausted_neighbours[f];
+        // Puissance du foyer
+        std::uint8_t  intensity = m_fire_front.intensity(i);
+
+
+        // On va tester les cases voisines pour contamination par le feu :
+        if (!(exhausted & (1u << SouthNorth)) &&
+            ignites(SouthNorth, f+m_time_step, intensity, m_vegetation_map[f+m_geometry]))
+        {
+            m_fire_map[f + m_geometry] = 255;
+            if (m_next_front.set(f + m_geometry, 255) != 255)
+                consume(f + m_geometry);
+        }
+
+        if (!(exhausted & (1u << NorthSouth)) &&
+            ignites(NorthSouth, f*13427+m_time_step, intensity, m_vegetation_map[f - m_geometry]))
+        {
+            m_fire_map[f - m_geometry] = 255;
+            if (m_next_front.set(f - m_geometry, 255) != 255)
+                consume(f - m_geometry);
+        }
+
+        if (!(exhausted & (1u << EastWest)) &&
+            ignites(EastWest, f*13427*13427+m_time_step, intensity, m_vegetation_map[f+1]))
+        {
+            m_fire_map[f + 1] = 255;
+            if (m_next_front.set(f + 1, 255) != 255)
+                consume(f + 1);
+        }
+
+        if (!(exhausted & (1u << WestEast)) &&
+            ignites(WestEast, f*13427*13427*13427+m_time_step, intensity, m_vegetation_map[f - 1]))
+        {
+            m_fire_map[f - 1] = 255;
+            if (m_next_front.set(f - 1, 255) != 255)
+                consume(f - 1);
+        }
+        // Si le feu est à son max,
+        if (intensity == 255)
+        {   // On regarde si il commence à faiblir pour s'éteindre au bout d'un moment :
+            if (weakens(f * 52513 + m_time_step))
+                intensity >>= 1;
+        }
+        else
+            // Foyer en train de s'éteindre.
+            intensity >>= 1;
+        // Déjà dans le front suivant : la case vient d'être rallumée par un voisin
+        if (!m_next_front.contains(f))
+        {
+            m_fire_map[f] = intensity;
+            if (intensity > 0)
+                m_next_front.set(f, intensity);
+            if (intensity == 255)
+                consume(f);
+        }
+    }
+    // Foyers affaiblis et pas rallumés : seule l'intensité de chaque case du front est relue
+    m_fire_front.swap(m_next_front);
+    for (std::size_t i = 0; i < m_fire_front.size(); ++i)
+        if (m_fire_front.intensity(i) != 255)
+            consume(m_fire_front.index(i));
+    m_time_step += 1;
+    return !m_fire_front.empty();
+}
+// --------------------------------------------------------------------------------------------------------------------
+void 
+Model::exhaust( std::size_t t_index )
+{
+    LexicoIndices coord = get_lexicographic_from_index(t_index);
+    if (coord.row > 0)
+        m_exhausted_neighbours[t_index - m_geometry] |= 1u << SouthNorth;
+    if (coord.row < m_geometry-1)
+        m_exhausted_neighbours[t_index + m_geometry] |= 1u << NorthSouth;
+    if (coord.column > 0)
+        m_exhausted_neighbours[t_index - 1] |= 1u << EastWest;
+    if (coord.column < m_geometry-1)
+        m_exhausted_neighbours[t_index + 1] |= 1u << WestEast;
+}
+// --------------------------------------------------------------------------------------------------------------------
+double 
+Model::alpha( Direction t_direction ) const
+{
+    switch (t_direction)
+    {
+    case SouthNorth: return alphaSouthNorth;
+    case NorthSouth: return alphaNorthSouth;
+    case EastWest:   return alphaEastWest;
+    default:         return alphaWestEast;
+    }
+}
+// --------------------------------------------------------------------------------------------------------------------
+bool 
+Model::ignites( Direction t_direction, std::size_t t_seed, std::uint8_t t_power, std::uint8_t t_green_power ) const
+{
+    bool ignition = pseudo_random_raw(t_seed, m_time_step) <
+                    m_ignition_thresholds[(t_direction*256 + t_power)*256 + t_green_power];
+#if defined(VALIDATE_THRESHOLDS)
+    // Vérification par rapport au calcul flottant d'origine
+    double tirage     = pseudo_random(t_seed, m_time_step);
+    double correction = log_factor(t_power)*log_factor(t_green_power);
+    if (ignition != (tirage < alpha(t_direction)*p1*correction))
+        throw std::logic_error("Seuil d'allumage incohérent au pas de temps " + std::to_string(m_time_step));
+#endif
+    return ignition;
+}
+// --------------------------------------------------------------------------------------------------------------------
+bool 
+Model::weakens( std::size_t t_seed ) const
+{
+    bool weakening = pseudo_random_raw(t_seed, m_time_step) < m_extinction_threshold;
+#if defined(VALIDATE_THRESHOLDS)
+    if (weakening != (pseudo_random(t_seed, m_time_step) < p2))
+        throw std::logic_error("Seuil d'extinction incohérent au pas de temps " + std::to_string(m_time_step));
+#endif
+    return weakening;
+}
+// ====================================================================================================================
+std::size_t   
+Model::get_index_from_lexicographic_indices( LexicoIndices t_lexico_indices  ) const
+{
+    return t_lexico_indices.row*this->geometry() + t_lexico_indices.column;
+}
+// --------------------------------------------------------------------------------------------------------------------
+auto 
+Model::get_lexicographic_from_index( std::size_t t_global_index ) const -> LexicoIndices
+{
+    LexicoIndices ind_coords;
+    ind_coords.row    = t_global_index/this->geometry();
+    ind_coords.column = t_global_index%this->geometry();
+    return ind_coords;
+}
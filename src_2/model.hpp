@@ -1,51 +1,84 @@
-#pragma once
-#include <cstdint>
-#include <array>
-#include <vector>
-#include <unordered_map>
-
-/**
- * @brief 
- * 
- */
-class Model
-{
-public:
-    struct LexicoIndices
-    {
-        unsigned row, column;
-    };
-
-    Model( double t_length, unsigned t_discretization, std::array<double,2> t_wind,
-           LexicoIndices t_start_fire_position, double t_max_wind = 60. );
-    Model( Model const & ) = delete;
-    Model( Model      && ) = delete;
-    ~Model() = default;
-
-    Model& operator = ( Model const & ) = delete;
-    Model& operator = ( Model      && ) = delete;
-
-    bool update();
-
-    unsigned geometry() const { return m_geometry; }
-    std::vector<std::uint8_t> vegetal_map() const { return m_vegetation_map; }
-    std::vector<std::uint8_t> fire_map() const { return m_fire_map; }
-    std::size_t time_step() const { return m_time_step; }
-
-private:
-    std::size_t   get_index_from_lexicographic_indices( LexicoIndices t_lexico_indices  ) const;
-    LexicoIndices get_lexicographic_from_index        ( std::size_t t_global_index ) const;
-
-    double m_length;                    // Taille du carré représentant le terrain (en km)
-    double m_distance;                  // Taille d'une case du terrain modélisé
-    std::size_t m_time_step = 0;            // Dernier numéro du pas de temps calculé
-    unsigned m_geometry;                // Taille en nombre de cases de la carte 2D
-    std::array<double,2> m_wind{0.,0.}; // Vitesse et direction du vent suivant les axes x et y en km/h
-    double m_wind_speed;                // Norme euclidienne de la vitesse du vent
-    double m_max_wind; //+ Vitesse à partir de laquelle le feu ne peut pas se propager dans le sens opposé à celui du vent.
-    std::vector<std::uint8_t> m_vegetation_map, m_fire_map;
-    double p1{0.}, p2{0.};
-    double alphaEastWest, alphaWestEast, alphaSouthNorth, alphaNorthSouth;
-
-    std::unordered_map<std::size_t, std::uint8_t> m_fire_front;
-};
+#pragma once
+#include <cstdint>
+#include <array>
+#include <vector>
+#include "fire_front.hpp"
+#include "map_view.hpp"
+
+/**
+ * @brief 
+ * 
+ */
+class Model
+{
+public:
+    struct LexicoIndices
+    {
+        unsigned row, column;
+    };
+
+    Model( double t_length, unsigned t_discretization, std::array<double,2> t_wind,
+           LexicoIndices t_start_fire_position, double t_max_wind = 60. );
+    Model( Model const & ) = delete;
+    Model( Model      && ) = delete;
+    ~Model() = default;
+
+    Model& operator = ( Model const & ) = delete;
+    Model& operator = ( Model      && ) = delete;
+
+    bool update();
+
+    unsigned geometry() const { return m_geometry; }
+    std::vector<std::uint8_t> vegetal_map() const { return m_vegetation_map; }
+    std::vector<std::uint8_t> fire_map() const { return m_fire_map; }
+    // Mêmes cartes, sans copie (voir map_view.hpp)
+    MapView vegetal_view() const { return MapView(m_vegetation_map.data(), m_geometry, m_geometry, m_geometry); }
+    MapView fire_view() const { return MapView(m_fire_map.data(), m_geometry, m_geometry, m_geometry); }
+    // Copie unique des deux cartes, qui reste valide pendant que le modèle avance
+    MapSnapshot snapshot() const { return MapSnapshot(m_time_step, fire_view(), vegetal_view()); }
+    std::size_t time_step() const { return m_time_step; }
+    // Cases du front parcourues depuis le début, cumulées sur les pas de temps (travail réellement fait)
+    std::size_t processed_cells() const { return m_processed_cells; }
+
+private:
+    // Direction de propagation, repérée par le coefficient de vent associé
+    enum Direction { SouthNorth = 0, NorthSouth, EastWest, WestEast };
+
+    double alpha  ( Direction t_direction ) const;
+    bool   ignites( Direction t_direction, std::size_t t_seed, std::uint8_t t_power, std::uint8_t t_green_power ) const;
+    bool   weakens( std::size_t t_seed ) const;
+    // Retire une unité de végétation à une case du front suivant
+    void   consume( std::size_t t_index )
+    {
+        if (m_vegetation_map[t_index] > 0)
+        {
+            m_vegetation_map[t_index] -= 1;
+            if (m_vegetation_map[t_index] == 0)
+                exhaust(t_index);
+        }
+    }
+    // La case n'a plus de végétation : ses voisins ne peuvent plus l'allumer
+    void   exhaust( std::size_t t_index );
+
+    std::size_t   get_index_from_lexicographic_indices( LexicoIndices t_lexico_indices  ) const;
+    LexicoIndices get_lexicographic_from_index        ( std::size_t t_global_index ) const;
+
+    double m_length;                    // Taille du carré représentant le terrain (en km)
+    double m_distance;                  // Taille d'une case du terrain modélisé
+    std::size_t m_time_step = 0;            // Dernier numéro du pas de temps calculé
+    std::size_t m_processed_cells = 0;      // Voir processed_cells()
+    unsigned m_geometry;                // Taille en nombre de cases de la carte 2D
+    std::array<double,2> m_wind{0.,0.}; // Vitesse et direction du vent suivant les axes x et y en km/h
+    double m_wind_speed;                // Norme euclidienne de la vitesse du vent
+    double m_max_wind; //+ Vitesse à partir de laquelle le feu ne peut pas se propager dans le sens opposé à celui du vent.
+    std::vector<std::uint8_t> m_vegetation_map, m_fire_map;
+    // Masque de saturation du voisinage : bit d de la case à 1 si son voisin dans la direction d est hors de la
+    // carte ou n'a plus de végétation. Ce voisin ne pourra plus jamais être allumé : son tirage est omis.
+    std::vector<std::uint8_t> m_exhausted_neighbours;
+    double p1{0.}, p2{0.};
+    double alphaEastWest, alphaWestEast, alphaSouthNorth, alphaNorthSouth;
+    std::vector<std::uint32_t> m_ignition_thresholds; // Seuils sur le tirage brut par (direction, puissance du foyer, végétation)
+    std::uint32_t m_extinction_threshold{0};          // Seuil sur le tirage brut équivalent à p2
+
+    FireFront m_fire_front, m_next_front; // Foyers actifs et foyers du pas de temps suivant
+};
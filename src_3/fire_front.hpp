@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Ensemble des cases en feu avec l'intensité du foyer associée.
+ *
+ * Les cases actives sont rangées de façon contiguë (indice + intensité) et une table de la taille
+ * de la carte donne la position de chaque case dans ce tableau dense. La table n'a jamais besoin
+ * d'être remise à zéro : une case appartient au front si sa position est valide et pointe bien sur elle.
+ * Insertion, suppression, recherche et vidage se font en O(1), le parcours est contigu et toute la
+ * mémoire est réservée à la construction (aucune allocation pendant la simulation).
+ */
+class FireFront
+{
+public:
+    explicit FireFront( std::size_t t_nb_cells )
+        :   m_slots(t_nb_cells, 0u)
+    {
+        m_cells.reserve(t_nb_cells);
+        m_intensities.reserve(t_nb_cells);
+    }
+
+    std::size_t size () const { return m_cells.size(); }
+    bool        empty() const { return m_cells.empty(); }
+
+    // Accès à la i-ème case du tableau dense :
+    std::size_t  index    ( std::size_t i ) const { return m_cells[i]; }
+    std::uint8_t intensity( std::size_t i ) const { return m_intensities[i]; }
+    std::uint32_t const * cells() const { return m_cells.data(); }
+
+    bool contains( std::size_t t_index ) const
+    {
+        std::uint32_t slot = m_slots[t_index];
+        return (slot < m_cells.size()) && (m_cells[slot] == t_index);
+    }
+
+    // Insère la case ou met à jour l'intensité si elle est déjà dans le front. Renvoie l'intensité précédente
+    // (zéro si la case n'était pas dans le front).
+    std::uint8_t set( std::size_t t_index, std::uint8_t t_intensity )
+    {
+        if (contains(t_index))
+        {
+            std::uint8_t& intensity = m_intensities[m_slots[t_index]];
+            std::uint8_t  previous  = intensity;
+            intensity = t_intensity;
+            return previous;
+        }
+        m_slots[t_index] = std::uint32_t(m_cells.size());
+        m_cells.push_back(std::uint32_t(t_index));
+        m_intensities.push_back(t_intensity);
+        return 0u;
+    }
+
+    // Retire la case en la remplaçant par la dernière du tableau dense
+    void erase( std::size_t t_index )
+    {
+        if (!contains(t_index)) return;
+        std::uint32_t slot = m_slots[t_index];
+        m_cells[slot]       = m_cells.back();
+        m_intensities[slot] = m_intensities.back();
+        m_slots[m_cells[slot]] = slot;
+        m_cells.pop_back();
+        m_intensities.pop_back();
+    }
+
+    void clear()
+    {
+        m_cells.clear();
+        m_intensities.clear();
+    }
+
+    // Échange du contenu avec t_other (double tampon : aucune copie ni allocation)
+    void swap( FireFront & t_other ) noexcept
+    {
+        m_slots.swap(t_other.m_slots);
+        m_cells.swap(t_other.m_cells);
+        m_intensities.swap(t_other.m_intensities);
+    }
+
+private:
+    std::vector<std::uint32_t> m_slots;       // Position de chaque case de la carte dans le tableau dense
+    std::vector<std::uint32_t> m_cells;       // Indices des cases en feu
+    std::vector<std::uint8_t>  m_intensities; // Intensité du feu pour chacune de ces cases
+};
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#include "frame.hpp"
+
+using namespace std::string_literals;
+
+namespace
+{
+    // Pixels t_out[0..t_count) des cases de végétation t_vegetation et d'intensité t_fire
+    using RowKernel = void (*)( std::uint8_t const * t_vegetation, std::uint8_t const * t_fire, std::size_t t_count,
+                                Frame::Palette const & t_palette, std::uint32_t * t_out );
+
+    void scalar_row( std::uint8_t const * t_vegetation, std::uint8_t const * t_fire, std::size_t t_count,
+                     Frame::Palette const & t_palette, std::uint32_t * t_out )
+    {
+        for (std::size_t i = 0; i < t_count; ++i)
+            t_out[i] = t_palette.fire[t_fire[i]] | t_palette.vegetation[t_vegetation[i]];
+    }
+
+#if defined(__x86_64__)
+    __attribute__((target("avx2")))
+    void avx2_row( std::uint8_t const * t_vegetation, std::uint8_t const * t_fire, std::size_t t_count,
+                   Frame::Palette const & t_palette, std::uint32_t * t_out )
+    {
+        auto const* fire_palette       = reinterpret_cast<int const*>(t_palette.fire.data());
+        auto const* vegetation_palette = reinterpret_cast<int const*>(t_palette.vegetation.data());
+        std::size_t i = 0;
+        for (; i + 8 <= t_count; i += 8)
+        {
+            __m256i fire  = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(t_fire + i)));
+            __m256i green = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(t_vegetation + i)));
+            __m256i pixel = _mm256_or_si256(_mm256_i32gather_epi32(fire_palette, fire, 4),
+                                            _mm256_i32gather_epi32(vegetation_palette, green, 4));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(t_out + i), pixel);
+        }
+        scalar_row(t_vegetation + i, t_fire + i, t_count - i, t_palette, t_out + i);
+    }
+#endif
+
+    struct Selection
+    {
+        RowKernel   kernel;
+        char const* name;
+    };
+
+    Selection detect()
+    {
+#if defined(__x86_64__)
+        __builtin_cpu_init();
+        char const* forced = std::getenv("FIRE_RENDER_KERNEL");
+        if ( (forced == nullptr || forced != "scalar"s) && __builtin_cpu_supports("avx2") )
+            return { avx2_row, "avx2" };
+#endif
+        return { scalar_row, "scalar" };
+    }
+
+    Selection const& selection()
+    {
+        static const Selection unique_selection = detect();
+        return unique_selection;
+    }
+
+    Frame::Palette make_palette()
+    {
+        Frame::Palette palette;
+        for (std::uint32_t value = 0; value < 256; ++value)
+        {
+            palette.fire[value]       = 0xFF000000u | (value << 16);
+            palette.vegetation[value] = value << 8;
+        }
+        return palette;
+    }
+
+    // Pixels des cases [t_column_begin, t_column_end) de la ligne t_row des cartes, écrits à partir de t_out
+    void render_row( MapView const & t_vegetation, MapView const & t_fire, unsigned t_row, unsigned t_column_begin,
+                     unsigned t_column_end, std::uint32_t * t_out )
+    {
+        selection().kernel(t_vegetation.row(t_row) + t_column_begin, t_fire.row(t_row) + t_column_begin,
+                           t_column_end - t_column_begin, Frame::palette(), t_out);
+    }
+}
+// ====================================================================================================================
+Frame::Frame( unsigned t_width, unsigned t_height )
+    :   m_width(t_width), m_height(t_height),
+        m_pixels(std::size_t(t_width) * t_height, 0xFF000000u)
+{}
+// --------------------------------------------------------------------------------------------------------------------
+void
+Frame::render( MapView const & t_vegetation, MapView const & t_fire )
+{
+    unsigned nb_rows    = std::min({m_height, t_vegetation.rows(), t_fire.rows()});
+    unsigned nb_columns = std::min({m_width, t_vegetation.columns(), t_fire.columns()});
+    for (unsigned row = 0; row < nb_rows; ++row)
+        render_row(t_vegetation, t_fire, row, 0, nb_columns,
+                   m_pixels.data() + std::size_t(m_height - 1 - row) * m_width);
+}
+// --------------------------------------------------------------------------------------------------------------------
+void
+Frame::render( MapView const & t_vegetation, MapView const & t_fire, DirtyTiles const & t_tiles )
+{
+    unsigned nb_rows    = std::min({m_height, t_vegetation.rows(), t_fire.rows()});
+    unsigned nb_columns = std::min({m_width, t_vegetation.columns(), t_fire.columns()});
+    for (unsigned tile_row = 0; tile_row < t_tiles.tile_rows(); ++tile_row)
+        t_tiles.for_each_span(tile_row, [&](unsigned t_row_begin, unsigned t_row_end,
+                                            unsigned t_column_begin, unsigned t_column_end)
+        {
+            t_column_end = std::min(t_column_end, nb_columns);
+            for (unsigned row = t_row_begin; (row < t_row_end) && (row < nb_rows); ++row)
+                if (t_column_begin < t_column_end)
+                    render_row(t_vegetation, t_fire, row, t_column_begin, t_column_end,
+                               m_pixels.data() + std::size_t(m_height - 1 - row) * m_width + t_column_begin);
+        });
+}
+// --------------------------------------------------------------------------------------------------------------------
+auto
+Frame::palette() -> Palette const &
+{
+    static const Palette unique_palette = make_palette();
+    return unique_palette;
+}
+// --------------------------------------------------------------------------------------------------------------------
+char const*
+Frame::kernel_name()
+{
+    return selection().name;
+}
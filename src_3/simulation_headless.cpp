@@ -0,0 +1,150 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "model.hpp"
+
+// Simulation sans affichage (ni SDL ni fenêtre), pour mesurer le débit du modèle seul, sur les nœuds de calcul
+// par exemple. Mêmes options de terrain que simulation (-l, -n, -w, -s) ; le résultat est donné en texte ou, avec
+// --json, en lignes JSON : une ligne "progress" tous les 32 pas de temps, puis une ligne "summary".
+// Les cases traitées sont les foyers du front que les pas de temps parcourent réellement (Model::processed_cells).
+// Sans processus d'affichage, le modèle tourne seul dans un processus (pas de MPI).
+using namespace std::string_literals;
+
+namespace
+{
+    struct Params
+    {
+        double length{1.};
+        unsigned discretization{20u};
+        std::array<double,2> wind{0.,0.};
+        Model::LexicoIndices start{10u,10u};
+        bool json{false};
+    };
+
+    [[noreturn]] void usage( std::string const & t_error )
+    {
+        if (!t_error.empty())
+            std::cerr << t_error << std::endl;
+        (t_error.empty() ? std::cout : std::cerr) <<
+R"RAW(Usage : simulation_headless [option(s)]
+  Lance la simulation d'incendie sans affichage et mesure son débit.
+  Les options sont :
+    -l, --longueur=LONGUEUR     Définit la taille LONGUEUR (réel en km) du carré représentant la carte de la végétation.
+    -n, --number_of_cases=N     Nombre n de cases par direction pour la discrétisation
+    -w, --wind=VX,VY            Définit le vecteur vitesse du vent (pas de vent par défaut).
+    -s, --start=COL,ROW         Définit les indices I,J de la case où commence l'incendie
+    -j, --json                  Résultats en lignes JSON (une mesure par ligne)
+)RAW";
+        exit(t_error.empty() ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    // Valeur de l'option -t_short VALEUR ou --t_long=VALEUR en tête de t_args (sinon faux) ; t_used reçoit le
+    // nombre d'arguments lus
+    bool option_value( int t_nargs, char* t_args[], char t_short, std::string const & t_long,
+                       std::string & t_value, int & t_used )
+    {
+        std::string key(t_args[0]);
+        if (key == "-"s + t_short)
+        {
+            if (t_nargs < 2)
+                usage("Manque une valeur pour l'option -"s + t_short + " !");
+            t_value = t_args[1];
+            t_used  = 2;
+            return true;
+        }
+        if (key.rfind("--"s + t_long + "=", 0) == 0)
+        {
+            t_value = std::string(key, t_long.size() + 3);
+            t_used  = 1;
+            return true;
+        }
+        return false;
+    }
+
+    std::array<double,2> parse_pair( std::string const & t_values )
+    {
+        auto pos = t_values.find(",");
+        if (pos == std::string::npos)
+            usage("Doit fournir deux valeurs séparées par une virgule : "s + t_values);
+        return { std::stod(t_values), std::stod(std::string(t_values, pos+1)) };
+    }
+
+    Params parse_arguments( int t_nargs, char* t_args[] )
+    {
+        Params params;
+        while (t_nargs > 0)
+        {
+            std::string key(t_args[0]), value;
+            int used = 1;
+            if ((key == "-h"s) || (key == "--help"s))
+                usage("");
+            else if ((key == "-j"s) || (key == "--json"s))
+                params.json = true;
+            else if (option_value(t_nargs, t_args, 'l', "longueur", value, used))
+                params.length = std::stod(value);
+            else if (option_value(t_nargs, t_args, 'n', "number_of_cases", value, used))
+                params.discretization = std::stoul(value);
+            else if (option_value(t_nargs, t_args, 'w', "wind", value, used))
+                params.wind = parse_pair(value);
+            else if (option_value(t_nargs, t_args, 's', "start", value, used))
+            {
+                auto start = parse_pair(value);
+                params.start.column = unsigned(start[0]);
+                params.start.row    = unsigned(start[1]);
+            }
+            else
+                usage("Option inconnue : "s + key);
+            t_nargs -= used;
+            t_args  += used;
+        }
+        if ((params.length <= 0) || (params.discretization == 0))
+            usage("[ERREUR FATALE] La longueur du terrain et le nombre de cases doivent être positifs et non nuls !");
+        if ((params.start.row >= params.discretization) || (params.start.column >= params.discretization))
+            usage("[ERREUR FATALE] Mauvais indices pour la position initiale du foyer");
+        return params;
+    }
+
+    // Une ligne JSON (event = "progress" ou "summary") ou, pour le résumé en texte, quelques lignes lisibles
+    void report( Params const & t_params, char const * t_event, Model const & t_model, double t_seconds )
+    {
+        double steps = double(t_model.time_step());
+        double cells = double(t_model.processed_cells());
+        double steps_per_second = (t_seconds > 0 ? steps / t_seconds : 0.);
+        double cells_per_second = (t_seconds > 0 ? cells / t_seconds : 0.);
+        if (t_params.json)
+        {
+            std::cout << "{\"event\":\"" << t_event << "\",\"n\":" << t_params.discretization
+                      << ",\"length\":" << t_params.length
+                      << ",\"wind\":[" << t_params.wind[0] << "," << t_params.wind[1] << "]"
+                      << ",\"start\":[" << t_params.start.column << "," << t_params.start.row << "]"
+                      << ",\"time_step\":" << t_model.time_step()
+                      << ",\"seconds\":" << t_seconds << ",\"steps_per_second\":" << steps_per_second
+                      << ",\"processed_cells\":" << t_model.processed_cells()
+                      << ",\"cells_per_second\":" << cells_per_second << "}" << std::endl;
+            return;
+        }
+        std::cout << "Dernier pas de temps : " << t_model.time_step() << std::endl
+                  << "Temps de calcul : " << t_seconds << " secondes" << std::endl
+                  << "Pas de temps par seconde : " << steps_per_second << std::endl
+                  << "Cases traitées : " << t_model.processed_cells() << std::endl
+                  << "Cases traitées par seconde : " << cells_per_second << std::endl;
+    }
+}
+
+int main( int nargs, char* args[] )
+{
+    auto params = parse_arguments(nargs-1, &args[1]);
+    Model simu( params.length, params.discretization, params.wind, params.start);
+
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&]() { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+    while (simu.update())
+    {
+        if (params.json && ((simu.time_step() & 31) == 0))
+            report(params, "progress", simu, elapsed());
+    }
+    report(params, "summary", simu, elapsed());
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,67 @@
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+#include "model.hpp"
+
+// Vérifie qu'un pas de temps n'alloue aucune mémoire. L'opérateur new global est remplacé par un compteur ; une
+// carte 2048 x 2048 fait un pas de mise en route puis 1000 pas comptés. Échoue si l'un des pas comptés alloue.
+namespace
+{
+    std::atomic<bool>        counting{false};
+    std::atomic<std::size_t> allocations{0};
+
+    void* allocate( std::size_t t_size )
+    {
+        if (counting.load(std::memory_order_relaxed))
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        if (void* pointer = std::malloc(t_size == 0 ? 1 : t_size))
+            return pointer;
+        throw std::bad_alloc();
+    }
+
+    void* allocate( std::size_t t_size, std::nothrow_t const & ) noexcept
+    {
+        try
+        {
+            return allocate(t_size);
+        }
+        catch (std::bad_alloc const &)
+        {
+            return nullptr;
+        }
+    }
+
+    constexpr unsigned    discretization = 2048;
+    constexpr std::size_t nb_steps       = 1000;
+
+    // Nombre d'allocations faites par les nb_steps pas qui suivent le pas de mise en route
+    std::size_t count_allocations()
+    {
+        Model simu(1., discretization, {5., 5.}, {discretization / 2, discretization / 2});
+        simu.update();
+        allocations = 0;
+        counting    = true;
+        for (std::size_t i = 0; (i < nb_steps) && simu.update(); ++i)
+            ;
+        counting = false;
+        return allocations;
+    }
+}
+
+void* operator new  ( std::size_t t_size ) { return allocate(t_size); }
+void* operator new[]( std::size_t t_size ) { return allocate(t_size); }
+void* operator new  ( std::size_t t_size, std::nothrow_t const & t_tag ) noexcept { return allocate(t_size, t_tag); }
+void* operator new[]( std::size_t t_size, std::nothrow_t const & t_tag ) noexcept { return allocate(t_size, t_tag); }
+void operator delete  ( void* t_pointer ) noexcept { std::free(t_pointer); }
+void operator delete[]( void* t_pointer ) noexcept { std::free(t_pointer); }
+void operator delete  ( void* t_pointer, std::size_t ) noexcept { std::free(t_pointer); }
+void operator delete[]( void* t_pointer, std::size_t ) noexcept { std::free(t_pointer); }
+
+int main()
+{
+    std::size_t count = count_allocations();
+    std::cout << count << " allocation(s) en " << nb_steps << " pas de temps" << std::endl;
+    return count > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -1,32 +1,67 @@
-#pragma once
-#include <vector>
-#include <cstdint>
-#include <memory>
-#if defined(__linux__)
-#  include <SDL2/SDL.h>
-#endif
-class Displayer
-{
-public:
-    Displayer( std::uint32_t width, std::uint32_t height );
-    Displayer( Displayer const & ) = delete;
-    Displayer( Displayer      && ) = delete;
-    ~Displayer();
-
-    Displayer& operator = ( Displayer const & ) = delete;
-    Displayer& operator = ( Displayer      && ) = delete;
-
-    void update( std::vector<std::uint8_t> const & vegetation_global_map,
-                 std::vector<std::uint8_t> const & fire_global_map );
-
-    static std::shared_ptr<Displayer> init_instance( std::uint32_t t_width, std::uint32_t t_height );
-    static std::shared_ptr<Displayer> instance();
-
-private:
-    static std::shared_ptr<Displayer> unique_instance;
-
-
-    SDL_Renderer *m_pt_renderer{nullptr};
-    SDL_Surface  *m_pt_surface{nullptr};
-    SDL_Window   *m_pt_window {nullptr};
-};
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include "frame.hpp"
+#include "lod.hpp"
+#include "map_view.hpp"
+#if defined(__linux__)
+#  include <SDL2/SDL.h>
+#endif
+/**
+ * @brief Fenêtre d'affichage des cartes (rouge : feu, vert : végétation).
+ *
+ * Chaque image est calculée dans un tampon ARGB (voir frame.hpp) puis envoyée en une fois dans une texture SDL en
+ * mode streaming. Si la texture ne peut pas être créée, ou si la variable d'environnement FIRE_RENDER vaut points,
+ * l'image est tracée case par case avec SDL_RenderDrawPoint. Avec les tuiles modifiées depuis l'image précédente,
+ * seuls leurs pixels sont recalculés et envoyés dans la texture : le coût d'une image suit la taille du front.
+ *
+ * Une carte plus grande que la fenêtre est montrée réduite (voir lod.hpp) : les niveaux réduits sont tenus à jour
+ * à partir des tuiles modifiées, et seule la partie visible du niveau choisi par le zoom est convertie en pixels
+ * puis agrandie à la taille de la fenêtre par SDL. Touches : + et - (zoom), flèches (déplacement), 0 (carte entière).
+ */
+class Displayer
+{
+public:
+    Displayer( std::uint32_t width, std::uint32_t height );
+    Displayer( Displayer const & ) = delete;
+    Displayer( Displayer      && ) = delete;
+    ~Displayer();
+
+    Displayer& operator = ( Displayer const & ) = delete;
+    Displayer& operator = ( Displayer      && ) = delete;
+
+    void update( std::vector<std::uint8_t> const & vegetation_global_map,
+                 std::vector<std::uint8_t> const & fire_global_map );
+    // Lit directement les cartes du modèle, sans copie
+    void update( MapView const & vegetation_global_map, MapView const & fire_global_map );
+    // Ne redessine que les tuiles modifiées depuis l'affichage précédent (tout, au premier affichage)
+    void update( MapView const & vegetation_global_map, MapView const & fire_global_map,
+                 DirtyTiles const & changed_tiles );
+    // Montre une image déjà réduite à la région visible (calculée par un autre processus par exemple)
+    void update( lod::Region const & region, MapView const & vegetation_region, MapView const & fire_region );
+
+    // Zoom et déplacement : vrai si l'événement est une touche qui les modifie
+    bool handle_event( SDL_Event const & event );
+    Viewport &       viewport()       { return m_viewport; }
+    Viewport const & viewport() const { return m_viewport; }
+
+    static std::shared_ptr<Displayer> init_instance( std::uint32_t t_width, std::uint32_t t_height );
+    static std::shared_ptr<Displayer> instance();
+
+private:
+    static std::shared_ptr<Displayer> unique_instance;
+
+    void draw( MapView const & vegetation_global_map, MapView const & fire_global_map );
+    void draw_points( MapView const & vegetation_global_map, MapView const & fire_global_map );
+
+    SDL_Renderer *m_pt_renderer{nullptr};
+    SDL_Surface  *m_pt_surface{nullptr};
+    SDL_Window   *m_pt_window {nullptr};
+    SDL_Texture  *m_pt_texture{nullptr}; // Texture de l'image (nulle : tracé case par case)
+    Frame         m_frame;
+    bool          m_frame_complete{false}; // Vrai si l'image montre toute la carte, case par pixel
+    Viewport      m_viewport;
+    Pyramid       m_pyramid;
+    bool          m_pyramid_complete{false}; // Vrai dès que les niveaux réduits ont été calculés une fois
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "dirty_tiles.hpp"
+#include "map_view.hpp"
+
+/**
+ * @brief Réduction des cartes pour les afficher dans une fenêtre plus petite que la grille.
+ *
+ * Au niveau k, une case couvre un bloc de 2^k x 2^k cases de la carte (moins sur les bords) : elle prend l'intensité
+ * maximale du feu dans le bloc, pour qu'un foyer isolé reste visible, et la végétation moyenne du bloc. Le niveau 0
+ * est la carte elle-même.
+ */
+namespace lod
+{
+    // Niveau le plus réduit : la somme des végétations d'un bloc de 2^12 x 2^12 cases tient encore sur 32 bits
+    constexpr unsigned max_level = 12;
+
+    // Nombre de cases du niveau t_level pour t_size cases de la carte (t_size > 0)
+    inline unsigned level_size( unsigned t_size, unsigned t_level ) { return ((t_size - 1) >> t_level) + 1; }
+
+    // Partie visible d'un niveau : rows x columns cases à partir de (first_row, first_column), en cases du niveau
+    struct Region
+    {
+        unsigned level, first_row, first_column, rows, columns;
+    };
+
+    // Cumule dans t_vegetation_sums (somme) et t_fire_max (maximum) les cases de la carte qui tombent dans la région,
+    // une valeur par case de la région rangées ligne par ligne. Les vues ne couvrent que les lignes
+    // [t_first_row, t_first_row + rows()) de la carte : chaque processus réduit ses lignes, et les résultats partiels
+    // se combinent par somme et maximum.
+    void accumulate( MapView const & t_vegetation, MapView const & t_fire, unsigned t_first_row,
+                     Region const & t_region, std::uint32_t * t_vegetation_sums, std::uint8_t * t_fire_max );
+    // Végétation moyenne de chaque case de la région, à partir des sommes d'une carte de t_rows x t_columns cases
+    void average( Region const & t_region, unsigned t_rows, unsigned t_columns,
+                  std::uint32_t const * t_vegetation_sums, std::uint8_t * t_vegetation );
+}
+
+/**
+ * @brief Partie des cartes montrée dans une fenêtre de width x height pixels, avec zoom et déplacement.
+ *
+ * Le zoom z choisit le niveau de réduction : pour z >= 0, le niveau z est montré à une case par pixel ; pour z < 0,
+ * le niveau 0 est agrandi 2^-z fois. Au départ, le zoom est celui du premier niveau qui tient entier dans la fenêtre
+ * (fit_level) et on ne peut pas réduire davantage. Le centre de la vue est donné en cases de la carte.
+ */
+class Viewport
+{
+public:
+    static constexpr int max_magnification = 3; // Au plus 2^3 pixels par case
+    using State = std::array<int, 3>;           // Zoom, ligne et colonne du centre (échangés entre processus)
+
+    Viewport( unsigned t_width, unsigned t_height );
+
+    // Dimensions de la carte montrée, à donner avant tout appel à region ; si elles changent, la vue revient à la
+    // carte entière
+    void set_map( unsigned t_rows, unsigned t_columns );
+
+    unsigned width    () const { return m_width;     }
+    unsigned height   () const { return m_height;    }
+    unsigned fit_level() const { return m_fit_level; }
+
+    lod::Region region() const;
+    // Vrai si la carte entière est montrée à une case par pixel, dans une fenêtre de sa taille
+    bool shows_whole_map() const;
+
+    void zoom_in ();
+    void zoom_out();
+    // Déplace le centre de t_rows (vers le haut) et t_columns (vers la droite) quarts de la partie visible
+    void pan( int t_rows, int t_columns );
+    void reset();
+
+    State state    () const { return { m_zoom, int(m_center_row), int(m_center_column) }; }
+    void  set_state( State const & t_state );
+
+private:
+    unsigned m_width, m_height;
+    unsigned m_rows = 0, m_columns = 0;
+    unsigned m_fit_level = 0;
+    int      m_zoom = 0;
+    unsigned m_center_row = 0, m_center_column = 0;
+};
+
+/**
+ * @brief Niveaux réduits 1 à top_level() des cartes, gardés d'une image à l'autre.
+ *
+ * Le niveau k est calculé à partir du niveau k - 1 : maximum et moyenne arrondie de 2 x 2 cases (une ligne ou une
+ * colonne seule au bord compte double). Avec les tuiles modifiées depuis la mise à jour précédente, seules les cases
+ * qui les couvrent sont recalculées ; les niveaux où une case déborde d'une tuile, petits, sont recalculés en entier.
+ */
+class Pyramid
+{
+public:
+    // Niveaux 1 à t_top_level pour une carte de t_rows x t_columns cases (ne fait rien s'ils existent déjà)
+    void resize( unsigned t_rows, unsigned t_columns, unsigned t_top_level );
+
+    unsigned rows     () const { return m_rows;    }
+    unsigned columns  () const { return m_columns; }
+    unsigned top_level() const { return unsigned(m_levels.size()); }
+
+    void build ( MapView const & t_vegetation, MapView const & t_fire );
+    void update( MapView const & t_vegetation, MapView const & t_fire, DirtyTiles const & t_tiles );
+
+    // Niveau t_level, de 1 à top_level()
+    MapView vegetation( unsigned t_level ) const;
+    MapView fire      ( unsigned t_level ) const;
+
+private:
+    struct Level
+    {
+        unsigned rows, columns;
+        std::vector<std::uint8_t> vegetation, fire;
+    };
+
+    unsigned m_rows = 0, m_columns = 0;
+    std::vector<Level> m_levels; // m_levels[k - 1] : niveau k
+};
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Vue en lecture seule sur une carte du modèle, sans copie.
+ *
+ * La vue couvre rows() lignes de columns() cases ; deux lignes consécutives sont séparées de stride cases (les
+ * cartes du modèle peuvent être stockées avec une bordure). La vue reste liée au modèle : elle montre l'état
+ * courant et n'est plus valide si le modèle est détruit. Pour garder l'état d'un pas de temps pendant que le modèle
+ * avance, voir MapSnapshot.
+ */
+class MapView
+{
+public:
+    MapView( std::uint8_t const * t_data, unsigned t_rows, unsigned t_columns, std::size_t t_stride )
+        :   m_data(t_data), m_stride(t_stride), m_rows(t_rows), m_columns(t_columns)
+    {}
+
+    unsigned    rows   () const { return m_rows;    }
+    unsigned    columns() const { return m_columns; }
+    std::size_t stride () const { return m_stride;  }
+
+    std::uint8_t operator () ( unsigned t_row, unsigned t_column ) const
+    {
+        return m_data[t_row * m_stride + t_column];
+    }
+
+    std::uint8_t const * row( unsigned t_row ) const { return m_data + t_row * m_stride; }
+
+    // Vue sur t_rows x t_columns cases à partir de la case (t_first_row, t_first_column), sans copie
+    MapView sub( unsigned t_first_row, unsigned t_first_column, unsigned t_rows, unsigned t_columns ) const
+    {
+        return MapView(row(t_first_row) + t_first_column, t_rows, t_columns, m_stride);
+    }
+
+    // Copie les cases ligne par ligne, sans bordure, à partir de t_out
+    void copy_to( std::uint8_t * t_out ) const
+    {
+        for (unsigned row_index = 0; row_index < m_rows; ++row_index, t_out += m_columns)
+            std::copy_n(row(row_index), m_columns, t_out);
+    }
+
+private:
+    std::uint8_t const * m_data;    // Case (0, 0) de la vue
+    std::size_t          m_stride;
+    unsigned             m_rows, m_columns;
+};
+
+/**
+ * @brief État des cartes de feu et de végétation à un pas de temps, en lecture seule.
+ *
+ * Les deux cartes sont copiées une seule fois, sans bordure, dans un tampon partagé : copier le MapSnapshot ne
+ * recopie pas les cartes, et il reste valide pendant que le modèle avance (affichage ou hachage par un autre thread).
+ */
+class MapSnapshot
+{
+public:
+    MapSnapshot() = default;
+    MapSnapshot( std::size_t t_time_step, MapView const & t_fire, MapView const & t_vegetation )
+        :   m_time_step(t_time_step), m_rows(t_fire.rows()), m_columns(t_fire.columns())
+    {
+        auto data = std::make_shared<std::vector<std::uint8_t>>(2 * cells());
+        t_fire.copy_to(data->data());
+        t_vegetation.copy_to(data->data() + cells());
+        m_data = std::move(data);
+    }
+
+    bool        valid    () const { return m_data != nullptr; }
+    std::size_t time_step() const { return m_time_step; }
+
+    MapView fire      () const { return MapView(bytes(),           m_rows, m_columns, m_columns); }
+    MapView vegetation() const { return MapView(bytes() + cells(), m_rows, m_columns, m_columns); }
+
+    // Carte de feu suivie de la carte de végétation, ligne par ligne
+    std::uint8_t const * bytes() const { return m_data->data(); }
+    std::size_t          size () const { return m_data->size(); }
+
+private:
+    std::size_t cells() const { return std::size_t(m_rows) * m_columns; }
+
+    std::size_t m_time_step = 0;
+    unsigned    m_rows = 0, m_columns = 0;
+    std::shared_ptr<std::vector<std::uint8_t> const> m_data;
+};
@@ -1,187 +1,365 @@
-#include <stdexcept>
-#include <cmath>
-#include <iostream>
-#include "model.hpp"
-
-namespace {
-    double pseudo_random(std::size_t index, std::size_t time_step) {
-        std::uint_fast32_t xi = std::uint_fast32_t(index * (time_step + 1));
-        std::uint_fast32_t r = (48271 * xi) % 2147483647;
-        return r / 2147483646.;
-    }
-
-    double log_factor(std::uint8_t value) {
-        return std::log(1. + value) / std::log(256);
-    }
-}
-
-Model::Model(double t_length, unsigned t_discretization, std::array<double,2> t_wind,
-             LexicoIndices t_start_fire_position, int rank, int nbp, double t_max_wind)
-    : m_length(t_length),
-      m_distance(-1),
-      m_geometry(t_discretization),
-      m_wind(t_wind),
-      m_wind_speed(std::sqrt(t_wind[0] * t_wind[0] + t_wind[1] * t_wind[1])),
-      m_max_wind(t_max_wind),
-      m_rank(rank),
-      m_nbp(nbp) {
-    if (t_discretization == 0) {
-        throw std::range_error("Le nombre de cases par direction doit être plus grand que zéro.");
-    }
-    m_distance = m_length / double(m_geometry);
-
-    // Calcul des indices locaux
-    unsigned N = m_geometry;
-    unsigned base_rows = N / m_nbp;
-    unsigned extra_rows = N % m_nbp;
-    m_local_rows = base_rows + (m_rank < extra_rows ? 1 : 0);
-    m_first_row = m_rank * base_rows + std::min(static_cast<unsigned>(m_rank), extra_rows);
-    m_last_row = m_first_row + m_local_rows - 1;
-
-    // Allocation des cartes locales avec fantômes
-    unsigned local_size = (m_local_rows + 2) * m_geometry;
-    m_local_vegetation_map.resize(local_size, 255u);
-    m_local_fire_map.resize(local_size, 0u);
-
-    // Initialisation du foyer
-    if (m_first_row <= t_start_fire_position.row && t_start_fire_position.row < m_first_row + m_local_rows) {
-        unsigned local_row = t_start_fire_position.row - m_first_row + 1;
-        std::size_t local_index = local_row * m_geometry + t_start_fire_position.column;
-        m_local_fire_map[local_index] = 255u;
-        m_fire_front[local_index] = 255u;
-    }
-
-    // Initialisation des paramètres 
-    constexpr double alpha0 = 4.52790762e-01;
-    constexpr double alpha1 = 9.58264437e-04;
-    constexpr double alpha2 = 3.61499382e-05;
-
-    if (m_wind_speed < t_max_wind)
-        p1 = alpha0 + alpha1 * m_wind_speed + alpha2 * (m_wind_speed * m_wind_speed);
-    else
-        p1 = alpha0 + alpha1 * t_max_wind + alpha2 * (t_max_wind * t_max_wind);
-    p2 = 0.3;
-
-    if (m_wind[0] > 0) {
-        alphaEastWest = std::abs(m_wind[0] / t_max_wind) + 1;
-        alphaWestEast = 1. - std::abs(m_wind[0] / t_max_wind);
-    } else {
-        alphaWestEast = std::abs(m_wind[0] / t_max_wind) + 1;
-        alphaEastWest = 1. - std::abs(m_wind[0] / t_max_wind);
-    }
-
-    if (m_wind[1] > 0) {
-        alphaSouthNorth = std::abs(m_wind[1] / t_max_wind) + 1;
-        alphaNorthSouth = 1. - std::abs(m_wind[1] / t_max_wind);
-    } else {
-        alphaNorthSouth = std::abs(m_wind[1] / t_max_wind) + 1;
-        alphaSouthNorth = 1. - std::abs(m_wind[1] / t_max_wind);
-    }
-}
-
-bool Model::update() {
-    // Échange des cellules fantômes
-    if (m_rank > 0) {
-        MPI_Sendrecv(&m_local_fire_map[m_geometry], m_geometry, MPI_UINT8_T, m_rank - 1, 0,
-                     &m_local_fire_map[0], m_geometry, MPI_UINT8_T, m_rank - 1, 0,
-                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-    }
-    if (m_rank < m_nbp - 1) {
-        MPI_Sendrecv(&m_local_fire_map[m_local_rows * m_geometry], m_geometry, MPI_UINT8_T, m_rank + 1, 0,
-                     &m_local_fire_map[(m_local_rows + 1) * m_geometry], m_geometry, MPI_UINT8_T, m_rank + 1, 0,
-                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-    }
-
-    std::vector<std::size_t> fire_keys;
-    for (const auto& pair : m_fire_front) {
-        fire_keys.push_back(pair.first);
-    }
-    auto next_front = m_fire_front;
-
-    for (size_t i = 0; i < fire_keys.size(); ++i) {
-        std::size_t f = fire_keys[i];
-        unsigned local_row = f / m_geometry;
-        unsigned column = f % m_geometry;
-
-        // Voisin du haut
-        if (local_row > 1 || (local_row == 1 && m_rank > 0)) {
-            std::size_t neighbor_f = f - m_geometry;
-            double tirage = pseudo_random(f + m_time_step, m_time_step);
-            double green_power = m_local_vegetation_map[neighbor_f];
-            double correction = log_factor(m_fire_front[f]) * log_factor(green_power);
-            if (tirage < alphaSouthNorth * p1 * correction) {
-                m_local_fire_map[neighbor_f] = 255;
-                next_front[neighbor_f] = 255;
-            }
-        }
-
-        // Voisin du bas
-        if (local_row < m_local_rows || (local_row == m_local_rows && m_rank < m_nbp - 1)) {
-            std::size_t neighbor_f = f + m_geometry;
-            double tirage = pseudo_random(f * 13427 + m_time_step, m_time_step);
-            double green_power = m_local_vegetation_map[neighbor_f];
-            double correction = log_factor(m_fire_front[f]) * log_factor(green_power);
-            if (tirage < alphaNorthSouth * p1 * correction) {
-                m_local_fire_map[neighbor_f] = 255;
-                next_front[neighbor_f] = 255;
-            }
-        }
-
-        // Voisins à droite et à gauche (pas de frontière horizontale)
-        if (column < m_geometry - 1) {
-            std::size_t neighbor_f = f + 1;
-            double tirage = pseudo_random(f * 13427 * 13427 + m_time_step, m_time_step);
-            double green_power = m_local_vegetation_map[neighbor_f];
-            double correction = log_factor(m_fire_front[f]) * log_factor(green_power);
-            if (tirage < alphaEastWest * p1 * correction) {
-                m_local_fire_map[neighbor_f] = 255;
-                next_front[neighbor_f] = 255;
-            }
-        }
-        if (column > 0) {
-            std::size_t neighbor_f = f - 1;
-            double tirage = pseudo_random(f * 13427 * 13427 * 13427 + m_time_step, m_time_step);
-            double green_power = m_local_vegetation_map[neighbor_f];
-            double correction = log_factor(m_fire_front[f]) * log_factor(green_power);
-            if (tirage < alphaWestEast * p1 * correction) {
-                m_local_fire_map[neighbor_f] = 255;
-                next_front[neighbor_f] = 255;
-            }
-        }
-
-        // Mise à jour du feu
-        if (m_fire_front[f] == 255) {
-            double tirage = pseudo_random(f * 52513 + m_time_step, m_time_step);
-            if (tirage < p2) {
-                m_local_fire_map[f] >>= 1;
-                next_front[f] >>= 1;
-            }
-        } else {
-            m_local_fire_map[f] >>= 1;
-            next_front[f] >>= 1;
-            if (next_front[f] == 0) {
-                next_front.erase(f);
-            }
-        }
-    }
-
-    m_fire_front = next_front;
-    for (auto& f : m_fire_front) {
-        if (m_local_vegetation_map[f.first] > 0) {
-            m_local_vegetation_map[f.first] -= 1;
-        }
-    }
-    m_time_step += 1;
-    return !m_fire_front.empty();
-}
-
-std::size_t Model::get_index_from_lexicographic_indices(LexicoIndices t_lexico_indices) const {
-    return t_lexico_indices.row * this->geometry() + t_lexico_indices.column;
-}
-
-Model::LexicoIndices Model::get_lexicographic_from_index(std::size_t t_global_index) const {
-    LexicoIndices ind_coords;
-    ind_coords.row = t_global_index / this->geometry();
-    ind_coords.column = t_global_index % this->geometry();
-    return ind_coords;
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "model.hpp"
+
+namespace {
+    std::uint_fast32_t pseudo_random_raw(std::size_t index, std::size_t time_step) {
+        std::uint_fast32_t xi = std::uint_fast32_t(index * (time_step + 1));
+        return (48271 * xi) % 2147483647;
+    }
+
+    [[maybe_unused]] double pseudo_random(std::size_t index, std::size_t time_step) {
+        return pseudo_random_raw(index, time_step) / 2147483646.;
+    }
+
+    double log_factor(std::uint8_t value) {
+        return std::log(1. + value) / std::log(256);
+    }
+
+    // Plus petit tirage brut r tel que r/2147483646. >= probability : le test flottant
+    // "pseudo_random(...) < probability" est alors exactement "pseudo_random_raw(...) < seuil".
+    std::uint32_t raw_threshold(double probability) {
+        if (!(probability > 0.)) return 0u;
+        if (probability > 1.) return 2147483647u;
+        std::uint64_t r = std::uint64_t(probability * 2147483646.);
+        while ((r > 0) && ((r - 1) / 2147483646. >= probability)) --r;
+        while ((r <= 2147483646u) && (r / 2147483646. < probability)) ++r;
+        return std::uint32_t(r);
+    }
+}
+
+Model::Model(double t_length, unsigned t_discretization, std::array<double,2> t_wind,
+             LexicoIndices t_start_fire_position, int rank, int nbp, double t_max_wind)
+    : m_length(t_length),
+      m_distance(-1),
+      m_geometry(t_discretization),
+      m_stride(t_discretization + 2),
+      m_wind(t_wind),
+      m_wind_speed(std::sqrt(t_wind[0] * t_wind[0] + t_wind[1] * t_wind[1])),
+      m_max_wind(t_max_wind),
+      m_rank(rank),
+      m_nbp(nbp),
+      m_fire_front(0),
+      m_next_front(0) {
+    if (t_discretization == 0) {
+        throw std::range_error("Le nombre de cases par direction doit être plus grand que zéro.");
+    }
+    m_distance = m_length / double(m_geometry);
+
+    // Calcul des indices locaux
+    unsigned N = m_geometry;
+    unsigned base_rows = N / m_nbp;
+    unsigned extra_rows = N % m_nbp;
+    m_local_rows = base_rows + (m_rank < extra_rows ? 1 : 0);
+    m_first_row = m_rank * base_rows + std::min(static_cast<unsigned>(m_rank), extra_rows);
+    m_last_row = m_first_row + m_local_rows - 1;
+
+    // Allocation des cartes locales avec fantômes et bordure
+    unsigned local_size = (m_local_rows + 2) * m_geometry;
+    m_local_vegetation_map.resize((m_local_rows + 4) * m_stride, 0u);
+    m_local_fire_map.resize((m_local_rows + 4) * m_stride, 0u);
+    unsigned first_green = (m_rank > 0) ? 0 : 1;
+    unsigned last_green = (m_rank < m_nbp - 1) ? m_local_rows + 1 : m_local_rows;
+    for (unsigned local_row = first_green; local_row <= last_green; ++local_row) {
+        std::fill_n(m_local_vegetation_map.begin() + position(local_row, 0), m_geometry, 255u);
+    }
+    // voisins que le front local n'allume jamais : sans végétation au départ (bordure), ou sur une ligne fantôme
+    // (la case est allumée par le processus qui la possède, à partir de sa copie de la ligne voisine)
+    m_exhausted_neighbours.resize(m_local_vegetation_map.size(), 0u);
+    for (unsigned local_row = 1; local_row <= m_local_rows; ++local_row) {
+        for (unsigned column = 0; column < m_geometry; ++column) {
+            std::size_t p = position(local_row, column);
+            bool top = (local_row == 1) || (m_local_vegetation_map[p - m_stride] == 0);
+            bool bottom = (local_row == m_local_rows) || (m_local_vegetation_map[p + m_stride] == 0);
+            m_exhausted_neighbours[p] = std::uint8_t((top << NorthSouth) | (bottom << SouthNorth) |
+                                                     ((m_local_vegetation_map[p + 1] == 0) << EastWest) |
+                                                     ((m_local_vegetation_map[p - 1] == 0) << WestEast));
+        }
+    }
+    m_fire_front = FireFront(local_size);
+    m_next_front = FireFront(local_size);
+
+    // Initialisation du foyer
+    if (m_first_row <= t_start_fire_position.row && t_start_fire_position.row < m_first_row + m_local_rows) {
+        unsigned local_row = t_start_fire_position.row - m_first_row + 1;
+        std::size_t local_index = local_row * m_geometry + t_start_fire_position.column;
+        std::size_t start = position(local_row, t_start_fire_position.column);
+        m_local_fire_map[start] = 255u;
+        m_fire_front.set(local_index, start, 255u);
+    }
+    m_digest = compute_digest();
+
+    // Initialisation des paramètres 
+    constexpr double alpha0 = 4.52790762e-01;
+    constexpr double alpha1 = 9.58264437e-04;
+    constexpr double alpha2 = 3.61499382e-05;
+
+    if (m_wind_speed < t_max_wind)
+        p1 = alpha0 + alpha1 * m_wind_speed + alpha2 * (m_wind_speed * m_wind_speed);
+    else
+        p1 = alpha0 + alpha1 * t_max_wind + alpha2 * (t_max_wind * t_max_wind);
+    p2 = 0.3;
+
+    if (m_wind[0] > 0) {
+        alphaEastWest = std::abs(m_wind[0] / t_max_wind) + 1;
+        alphaWestEast = 1. - std::abs(m_wind[0] / t_max_wind);
+    } else {
+        alphaWestEast = std::abs(m_wind[0] / t_max_wind) + 1;
+        alphaEastWest = 1. - std::abs(m_wind[0] / t_max_wind);
+    }
+
+    if (m_wind[1] > 0) {
+        alphaSouthNorth = std::abs(m_wind[1] / t_max_wind) + 1;
+        alphaNorthSouth = 1. - std::abs(m_wind[1] / t_max_wind);
+    } else {
+        alphaNorthSouth = std::abs(m_wind[1] / t_max_wind) + 1;
+        alphaSouthNorth = 1. - std::abs(m_wind[1] / t_max_wind);
+    }
+
+    // Tables des seuils entiers pour le test d'allumage et l'affaiblissement des foyers
+    m_ignition_thresholds.resize(4 * 256 * 256);
+    for (Direction direction : {SouthNorth, NorthSouth, EastWest, WestEast}) {
+        for (unsigned power = 0; power < 256; ++power) {
+            for (unsigned green_power = 0; green_power < 256; ++green_power) {
+                double correction = log_factor(power) * log_factor(green_power);
+                m_ignition_thresholds[(direction * 256 + power) * 256 + green_power] =
+                    raw_threshold(alpha(direction) * p1 * correction);
+            }
+        }
+    }
+    m_extinction_threshold = raw_threshold(p2);
+}
+
+bool Model::update() {
+    step();
+#if defined(VALIDATE_THRESHOLDS)
+    validate_digest();
+#endif
+    return !m_fire_front.empty();
+}
+
+bool Model::advance(std::size_t t_nb_steps, std::vector<StepSummary>& t_summaries) {
+    // toujours t_nb_steps pas, même si le front local est vide : chaque pas échange les fantômes avec les voisins,
+    // tous les processus doivent donc faire le même nombre de pas
+    t_summaries.reserve(t_summaries.size() + t_nb_steps);
+    for (std::size_t i = 0; i < t_nb_steps; ++i) {
+        std::size_t front_size = step();
+        t_summaries.push_back({m_time_step, front_size, m_burnt_cells});
+    }
+#if defined(VALIDATE_THRESHOLDS)
+    validate_digest();
+#endif
+    return !m_fire_front.empty();
+}
+
+std::size_t Model::step() {
+    // Échange des cellules fantômes
+    if (m_rank > 0) {
+        MPI_Sendrecv(&m_local_fire_map[position(1, 0)], m_geometry, MPI_UINT8_T, m_rank - 1, 0,
+                     &m_local_fire_map[position(0, 0)], m_geometry, MPI_UINT8_T, m_rank - 1, 0,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+    if (m_rank < m_nbp - 1) {
+        MPI_Sendrecv(&m_local_fire_map[position(m_local_rows, 0)], m_geometry, MPI_UINT8_T, m_rank + 1, 0,
+                     &m_local_fire_map[position(m_local_rows + 1, 0)], m_geometry, MPI_UINT8_T, m_rank + 1, 0,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+
+    // Front du pas suivant reconstruit dans le second tampon puis échangé avec le front courant.
+    // Une case allumée par un voisin au cours du pas repart à 255 quel que soit l'ordre de parcours.
+    m_next_front.clear();
+    m_processed_cells += m_fire_front.size();
+    // Toute case du front suivant perd une unité de végétation, et passe ici exactement une fois. Une case qui y
+    // entre à 255 la perd dès son écriture : un voisin traité plus tard ne lit plus sa végétation que pour la
+    // rallumer, ce qui ne change rien. Un foyer affaibli peut encore être rallumé par un voisin (le tirage dépend
+    // de sa végétation) : il n'est consommé qu'en fin de parcours, ou dès qu'il est rallumé.
+    std::size_t owned_front = 0;
+    auto consume = [this, &owned_front](std::size_t f, std::size_t p) {
+        std::uint8_t green = m_local_vegetation_map[p];
+        owned_front += owns(f);
+        if (green > 0) {
+            m_local_vegetation_map[p] = green - 1;
+            if (owns(f)) {
+                m_digest += state_digest::change(state_digest::Vegetation, global_index(f), green, green - 1);
+                m_burnt_cells += (green == 255);
+            }
+            if (green == 1) {
+                exhaust(p);
+            }
+        }
+    };
+    // Un voisin sans végétation (bordure) ou sur une ligne fantôme n'est pas allumé ici (masque de saturation) :
+    // aucun test de bord, ni décodage des coordonnées de la case.
+    for (std::size_t i = 0; i < m_fire_front.size(); ++i) {
+        std::size_t f = m_fire_front.index(i);
+        std::size_t p = m_fire_front.position(i);
+        std::uint8_t intensity = m_fire_front.intensity(i);
+        // germes des tirages : indice global de la case, pour que l'évolution ne dépende pas du nombre de processus
+        std::size_t g = global_index(f);
+
+        // un voisin sans végétation ne peut pas s'allumer : ni tirage ni comparaison
+        std::uint8_t exhausted = m_exhausted_neighbours[p];
+        // Voisin du bas
+        if (!(exhausted & (1u << SouthNorth)) &&
+            ignites(SouthNorth, g + m_time_step, intensity, m_local_vegetation_map[p + m_stride])) {
+            set_fire(f + m_geometry, p + m_stride, 255);
+            if (m_next_front.set(f + m_geometry, p + m_stride, 255) != 255) {
+                consume(f + m_geometry, p + m_stride);
+            }
+        }
+        // Voisin du haut
+        if (!(exhausted & (1u << NorthSouth)) &&
+            ignites(NorthSouth, g * 13427 + m_time_step, intensity, m_local_vegetation_map[p - m_stride])) {
+            set_fire(f - m_geometry, p - m_stride, 255);
+            if (m_next_front.set(f - m_geometry, p - m_stride, 255) != 255) {
+                consume(f - m_geometry, p - m_stride);
+            }
+        }
+        // Voisins à droite et à gauche
+        if (!(exhausted & (1u << EastWest)) &&
+            ignites(EastWest, g * 13427 * 13427 + m_time_step, intensity, m_local_vegetation_map[p + 1])) {
+            set_fire(f + 1, p + 1, 255);
+            if (m_next_front.set(f + 1, p + 1, 255) != 255) {
+                consume(f + 1, p + 1);
+            }
+        }
+        if (!(exhausted & (1u << WestEast)) &&
+            ignites(WestEast, g * 13427 * 13427 * 13427 + m_time_step, intensity, m_local_vegetation_map[p - 1])) {
+            set_fire(f - 1, p - 1, 255);
+            if (m_next_front.set(f - 1, p - 1, 255) != 255) {
+                consume(f - 1, p - 1);
+            }
+        }
+
+        // Mise à jour du feu
+        std::uint8_t next_intensity = intensity;
+        if (intensity == 255) {
+            if (weakens(g * 52513 + m_time_step)) {
+                next_intensity >>= 1;
+            }
+        } else {
+            next_intensity >>= 1;
+        }
+        // Déjà dans le front suivant : la case vient d'être rallumée par un voisin
+        if (!m_next_front.contains(f)) {
+            if (next_intensity != intensity) {
+                set_fire(f, p, m_local_fire_map[p] >> 1);
+            }
+            if (next_intensity > 0) {
+                m_next_front.set(f, p, next_intensity);
+            }
+            if (next_intensity == 255) {
+                consume(f, p);
+            }
+        }
+    }
+
+    // foyers des lignes fantômes (lignes voisines reçues en début de pas) : seuls leurs tirages vers les lignes du
+    // processus sont faits ici, avec les germes que leur donne le processus qui les possède
+    auto ghost_ignites = [&](unsigned t_ghost_row, unsigned t_row, Direction t_direction, std::size_t t_multiplier) {
+        for (unsigned column = 0; column < m_geometry; ++column) {
+            std::uint8_t intensity = m_local_fire_map[position(t_ghost_row, column)];
+            std::size_t f = std::size_t(t_row) * m_geometry + column, p = position(t_row, column);
+            if ((intensity == 0) || (m_local_vegetation_map[p] == 0)) {
+                continue;
+            }
+            std::size_t seed = global_index(std::size_t(t_ghost_row) * m_geometry + column) * t_multiplier;
+            if (ignites(t_direction, seed + m_time_step, intensity, m_local_vegetation_map[p])) {
+                set_fire(f, p, 255);
+                if (m_next_front.set(f, p, 255) != 255) {
+                    consume(f, p);
+                }
+            }
+        }
+    };
+    if (m_rank > 0) {
+        ghost_ignites(0, 1, SouthNorth, 1);
+    }
+    if (m_rank < m_nbp - 1) {
+        ghost_ignites(m_local_rows + 1, m_local_rows, NorthSouth, 13427);
+    }
+
+    // foyers affaiblis et pas rallumés : seule l'intensité de chaque case du front est relue
+    m_fire_front.swap(m_next_front);
+    for (std::size_t i = 0; i < m_fire_front.size(); ++i) {
+        if (m_fire_front.intensity(i) != 255) {
+            consume(m_fire_front.index(i), m_fire_front.position(i));
+        }
+    }
+    m_time_step += 1;
+    return owned_front;
+}
+
+double Model::alpha(Direction t_direction) const {
+    switch (t_direction) {
+    case SouthNorth: return alphaSouthNorth;
+    case NorthSouth: return alphaNorthSouth;
+    case EastWest:   return alphaEastWest;
+    default:         return alphaWestEast;
+    }
+}
+
+bool Model::ignites(Direction t_direction, std::size_t t_seed, std::uint8_t t_power, std::uint8_t t_green_power) const {
+    bool ignition = pseudo_random_raw(t_seed, m_time_step) <
+                    m_ignition_thresholds[(t_direction * 256 + t_power) * 256 + t_green_power];
+#if defined(VALIDATE_THRESHOLDS)
+    // Vérification par rapport au calcul flottant d'origine
+    double tirage = pseudo_random(t_seed, m_time_step);
+    double correction = log_factor(t_power) * log_factor(t_green_power);
+    if (ignition != (tirage < alpha(t_direction) * p1 * correction)) {
+        throw std::logic_error("Seuil d'allumage incohérent au pas de temps " + std::to_string(m_time_step));
+    }
+#endif
+    return ignition;
+}
+
+bool Model::weakens(std::size_t t_seed) const {
+    bool weakening = pseudo_random_raw(t_seed, m_time_step) < m_extinction_threshold;
+#if defined(VALIDATE_THRESHOLDS)
+    if (weakening != (pseudo_random(t_seed, m_time_step) < p2)) {
+        throw std::logic_error("Seuil d'extinction incohérent au pas de temps " + std::to_string(m_time_step));
+    }
+#endif
+    return weakening;
+}
+
+#if defined(VALIDATE_THRESHOLDS)
+void Model::validate_digest() const {
+    if (m_digest != compute_digest()) {
+        throw std::logic_error("Empreinte incrémentale incohérente au pas de temps " + std::to_string(m_time_step));
+    }
+}
+#endif
+
+std::uint64_t Model::compute_digest() const {
+    std::uint64_t digest = 0;
+    for (std::size_t local_row = 1; local_row <= m_local_rows; ++local_row) {
+        for (std::size_t column = 0; column < m_geometry; ++column) {
+            std::size_t f = global_index(local_row * m_geometry + column), p = position(local_row, column);
+            digest += state_digest::key(state_digest::Fire, f, m_local_fire_map[p]);
+            digest += state_digest::key(state_digest::Vegetation, f, m_local_vegetation_map[p]);
+        }
+    }
+    return digest;
+}
+
+std::vector<std::uint8_t> Model::without_border(std::vector<std::uint8_t> const& t_map) const {
+    std::vector<std::uint8_t> map(std::size_t(m_local_rows + 2) * m_geometry);
+    for (std::size_t local_row = 0; local_row < m_local_rows + 2; ++local_row) {
+        std::copy_n(t_map.begin() + position(local_row, 0), m_geometry, map.begin() + local_row * m_geometry);
+    }
+    return map;
+}
+
+std::size_t Model::get_index_from_lexicographic_indices(LexicoIndices t_lexico_indices) const {
+    return t_lexico_indices.row * this->geometry() + t_lexico_indices.column;
+}
+
+Model::LexicoIndices Model::get_lexicographic_from_index(std::size_t t_global_index) const {
+    LexicoIndices ind_coords;
+    ind_coords.row = t_global_index / this->geometry();
+    ind_coords.column = t_global_index % this->geometry();
+    return ind_coords;
 }
\ No newline at end of file
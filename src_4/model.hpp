@@ -1,55 +1,139 @@
-#pragma once
-#include <cstdint>
-#include <array>
-#include <vector>
-#include <unordered_map>
-#include <mpi.h>
-
-class Model {
-public:
-    struct LexicoIndices {
-        unsigned row, column;
-    };
-
-    // rank et nbp pour la parallélisation
-    Model(double t_length, unsigned t_discretization, std::array<double,2> t_wind,
-          LexicoIndices t_start_fire_position, int rank, int nbp, double t_max_wind = 60.);
-
-    Model(Model const&) = delete;
-    Model(Model&&) = delete;
-    ~Model() = default;
-
-    Model& operator=(Model const&) = delete;
-    Model& operator=(Model&&) = delete;
-
-    bool update();
-
-    unsigned geometry() const { return m_geometry; }
-    // cartes locales
-    std::vector<std::uint8_t> const& vegetal_map() const { return m_local_vegetation_map; }
-    std::vector<std::uint8_t> const& fire_map() const { return m_local_fire_map; }
-    std::size_t time_step() const { return m_time_step; }
-
-    unsigned m_local_rows;
-
-private:
-    std::size_t get_index_from_lexicographic_indices(LexicoIndices t_lexico_indices) const;
-    LexicoIndices get_lexicographic_from_index(std::size_t t_global_index) const;
-
-    double m_length;
-    double m_distance;
-    std::size_t m_time_step = 0;
-    unsigned m_geometry;
-    std::array<double,2> m_wind{0.,0.};
-    double m_wind_speed;
-    double m_max_wind;
-
-    // cartes locales avec fantômes
-    std::vector<std::uint8_t> m_local_vegetation_map, m_local_fire_map;
-    int m_rank, m_nbp;
-    unsigned m_first_row, m_last_row;
-
-    double p1{0.}, p2{0.};
-    double alphaEastWest, alphaWestEast, alphaSouthNorth, alphaNorthSouth;
-    std::unordered_map<std::size_t, std::uint8_t> m_fire_front;
+#pragma once
+#include <cstdint>
+#include <array>
+#include <vector>
+#include "fire_front.hpp"
+#include "map_view.hpp"
+#include "state_digest.hpp"
+#include <mpi.h>
+
+class Model {
+public:
+    struct LexicoIndices {
+        unsigned row, column;
+    };
+
+    // rank et nbp pour la parallélisation
+    Model(double t_length, unsigned t_discretization, std::array<double,2> t_wind,
+          LexicoIndices t_start_fire_position, int rank, int nbp, double t_max_wind = 60.);
+
+    Model(Model const&) = delete;
+    Model(Model&&) = delete;
+    ~Model() = default;
+
+    Model& operator=(Model const&) = delete;
+    Model& operator=(Model&&) = delete;
+
+    bool update();
+
+    // résumé d'un pas de temps calculé par advance, restreint aux lignes du processus (à additionner entre processus)
+    struct StepSummary {
+        std::size_t time_step;   // numéro du pas de temps
+        std::size_t front_size;  // cases du processus en feu à la fin du pas
+        std::size_t burnt_cells; // cases du processus touchées par le feu depuis le début (végétation entamée)
+    };
+    // calcule t_nb_steps pas de temps à la suite, sans copier les cartes entre deux pas, et ajoute le résumé de
+    // chacun à t_summaries. Collectif : tous les processus font les t_nb_steps pas, même si leur front est vide ; le
+    // pas où le feu s'éteint est le premier dont la somme des front_size est nulle. Renvoie le résultat d'update()
+    // pour le dernier pas.
+    bool advance(std::size_t t_nb_steps, std::vector<StepSummary>& t_summaries);
+
+    unsigned geometry() const { return m_geometry; }
+    // cartes locales avec fantômes, sans la bordure
+    std::vector<std::uint8_t> vegetal_map() const { return without_border(m_local_vegetation_map); }
+    std::vector<std::uint8_t> fire_map() const { return without_border(m_local_fire_map); }
+    // lignes propres au processus, sans copie (voir map_view.hpp) : la ligne 0 de la vue est la ligne first_row()
+    MapView vegetal_view() const {
+        return MapView(m_local_vegetation_map.data() + position(1, 0), m_local_rows, m_geometry, m_stride);
+    }
+    MapView fire_view() const {
+        return MapView(m_local_fire_map.data() + position(1, 0), m_local_rows, m_geometry, m_stride);
+    }
+    // copie unique des lignes propres au processus, qui reste valide pendant que le modèle avance
+    MapSnapshot snapshot() const { return MapSnapshot(m_time_step, fire_view(), vegetal_view()); }
+    std::size_t time_step() const { return m_time_step; }
+    unsigned first_row() const { return m_first_row; } // première ligne globale du processus
+    // empreinte des lignes du processus (voir state_digest.hpp), tenue à jour en O(1) par écriture : la somme
+    // (MPI_SUM) sur tous les processus donne l'empreinte de la carte entière, calculée comme dans src_0 et src_1 :
+    // mêmes tirages dans les mêmes directions, donc la même suite d'empreintes quel que soit le nombre de processus
+    std::uint64_t digest() const { return m_digest; }
+    std::size_t burnt_cells() const { return m_burnt_cells; }
+    // foyers du front du processus parcourus depuis le début, cumulés sur les pas de temps (à additionner entre
+    // processus) : le travail réellement fait
+    std::size_t processed_cells() const { return m_processed_cells; }
+
+    unsigned m_local_rows;
+
+private:
+    // Direction de propagation, repérée par le coefficient de vent associé
+    enum Direction { SouthNorth = 0, NorthSouth, EastWest, WestEast };
+
+    double alpha(Direction t_direction) const;
+    bool ignites(Direction t_direction, std::size_t t_seed, std::uint8_t t_power, std::uint8_t t_green_power) const;
+    bool weakens(std::size_t t_seed) const;
+    std::size_t step(); // un pas de temps ; renvoie le nombre de cases du processus dans le front
+
+    // position de la case (ligne locale, colonne) dans les cartes stockées avec leur bordure
+    std::size_t position(std::size_t t_local_row, std::size_t t_column) const {
+        return (t_local_row + 1) * m_stride + t_column + 1;
+    }
+    std::vector<std::uint8_t> without_border(std::vector<std::uint8_t> const& t_map) const;
+
+    // seules les lignes propres au processus comptent dans l'empreinte (les fantômes sont comptés par leur propriétaire)
+    bool owns(std::size_t t_local_index) const {
+        return (t_local_index >= m_geometry) && (t_local_index < std::size_t(m_local_rows + 1) * m_geometry);
+    }
+    std::size_t global_index(std::size_t t_local_index) const {
+        return t_local_index + std::size_t(m_first_row) * m_geometry - m_geometry;
+    }
+    // allume ou affaiblit la case en tenant l'empreinte à jour
+    void set_fire(std::size_t t_local_index, std::size_t t_position, std::uint8_t t_intensity) {
+        if (owns(t_local_index)) {
+            m_digest += state_digest::change(state_digest::Fire, global_index(t_local_index),
+                                             m_local_fire_map[t_position], t_intensity);
+        }
+        m_local_fire_map[t_position] = t_intensity;
+    }
+    // la case t_position n'a plus de végétation : ses quatre voisins ne peuvent plus l'allumer
+    void exhaust(std::size_t t_position) {
+        m_exhausted_neighbours[t_position - m_stride] |= 1u << SouthNorth;
+        m_exhausted_neighbours[t_position + m_stride] |= 1u << NorthSouth;
+        m_exhausted_neighbours[t_position - 1] |= 1u << EastWest;
+        m_exhausted_neighbours[t_position + 1] |= 1u << WestEast;
+    }
+    std::uint64_t compute_digest() const; // empreinte recalculée sur les lignes du processus
+#if defined(VALIDATE_THRESHOLDS)
+    void validate_digest() const;
+#endif
+
+    std::size_t get_index_from_lexicographic_indices(LexicoIndices t_lexico_indices) const;
+    LexicoIndices get_lexicographic_from_index(std::size_t t_global_index) const;
+
+    double m_length;
+    double m_distance;
+    std::size_t m_time_step = 0;
+    unsigned m_geometry;
+    unsigned m_stride; // longueur d'une ligne des cartes stockées (bordure comprise)
+    std::array<double,2> m_wind{0.,0.};
+    double m_wind_speed;
+    double m_max_wind;
+
+    // cartes locales avec fantômes, stockées avec une bordure d'une case sans végétation (une ligne au-dessus et
+    // au-dessous des fantômes, une colonne de chaque côté). Les fantômes des bords du domaine n'ont pas non plus
+    // de végétation : aucun voisin n'y prend feu et le parcours du front n'a aucun test de bord.
+    std::vector<std::uint8_t> m_local_vegetation_map, m_local_fire_map;
+    // masque de saturation du voisinage : bit d de la case p à 1 si son voisin dans la direction d n'a plus de
+    // végétation (bordure comprise) ou est sur une ligne fantôme ; il ne sera plus allumé ici et son tirage est omis
+    std::vector<std::uint8_t> m_exhausted_neighbours;
+    int m_rank, m_nbp;
+    unsigned m_first_row, m_last_row;
+    std::uint64_t m_digest = 0;
+    std::size_t m_burnt_cells = 0; // cases du processus dont la végétation est entamée
+    std::size_t m_processed_cells = 0; // voir processed_cells()
+
+    double p1{0.}, p2{0.};
+    double alphaEastWest, alphaWestEast, alphaSouthNorth, alphaNorthSouth;
+    std::vector<std::uint32_t> m_ignition_thresholds; // seuils sur le tirage brut par (direction, puissance, végétation)
+    std::uint32_t m_extinction_threshold{0};          // seuil sur le tirage brut équivalent à p2
+    FireFront m_fire_front, m_next_front;
 };
\ No newline at end of file
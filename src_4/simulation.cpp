@@ -1,288 +1,437 @@
-#include <string>
-#include <cstdlib>
-#include <cassert>
-#include <iostream>
-#include <thread>
-#include <chrono>
-#include <mpi.h>
-
-#include "model.hpp"
-#include "display.hpp"
-
-using namespace std::string_literals;
-using namespace std::chrono_literals;
-
-struct ParamsType
-{
-    double length{1.};
-    unsigned discretization{20u};
-    std::array<double,2> wind{0.,0.};
-    Model::LexicoIndices start{10u,10u};
-};
-
-void analyze_arg(int nargs, char* args[], ParamsType& params)
-{
-    if (nargs == 0) return;
-    std::string key(args[0]);
-    if (key == "-l"s)
-    {
-        if (nargs < 2)
-        {
-            std::cerr << "Manque une valeur pour la longueur du terrain !" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        params.length = std::stoul(args[1]);
-        analyze_arg(nargs-2, &args[2], params);
-        return;
-    }
-    auto pos = key.find("--longueur=");
-    if (pos < key.size())
-    {
-        auto subkey = std::string(key, pos+11);
-        params.length = std::stoul(subkey);
-        analyze_arg(nargs-1, &args[1], params);
-        return;
-    }
-
-    if (key == "-n"s)
-    {
-        if (nargs < 2)
-        {
-            std::cerr << "Manque une valeur pour le nombre de cases par direction pour la discrétisation du terrain !" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        params.discretization = std::stoul(args[1]);
-        analyze_arg(nargs-2, &args[2], params);
-        return;
-    }
-    pos = key.find("--number_of_cases=");
-    if (pos < key.size())
-    {
-        auto subkey = std::string(key, pos+18);
-        params.discretization = std::stoul(subkey);
-        analyze_arg(nargs-1, &args[1], params);
-        return;
-    }
-
-    if (key == "-w"s)
-    {
-        if (nargs < 2)
-        {
-            std::cerr << "Manque une paire de valeurs pour la direction du vent !" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        std::string values = std::string(args[1]);
-        params.wind[0] = std::stod(values);
-        auto pos = values.find(",");
-        if (pos == values.size())
-        {
-            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la vitesse" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        auto second_value = std::string(values, pos+1);
-        params.wind[1] = std::stod(second_value);
-        analyze_arg(nargs-2, &args[2], params);
-        return;
-    }
-    pos = key.find("--wind=");
-    if (pos < key.size())
-    {
-        auto subkey = std::string(key, pos+7);
-        params.wind[0] = std::stoul(subkey);
-        auto pos = subkey.find(",");
-        if (pos == subkey.size())
-        {
-            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la vitesse" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        auto second_value = std::string(subkey, pos+1);
-        params.wind[1] = std::stod(second_value);
-        analyze_arg(nargs-1, &args[1], params);
-        return;
-    }
-
-    if (key == "-s"s)
-    {
-        if (nargs < 2)
-        {
-            std::cerr << "Manque une paire de valeurs pour la position du foyer initial !" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        std::string values = std::string(args[1]);
-        params.start.column = std::stod(values);
-        auto pos = values.find(",");
-        if (pos == values.size())
-        {
-            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la position du foyer initial" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        auto second_value = std::string(values, pos+1);
-        params.start.row = std::stod(second_value);
-        analyze_arg(nargs-2, &args[2], params);
-        return;
-    }
-    pos = key.find("--start=");
-    if (pos < key.size())
-    {
-        auto subkey = std::string(key, pos+8);
-        params.start.column = std::stoul(subkey);
-        auto pos = subkey.find(",");
-        if (pos == subkey.size())
-        {
-            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la vitesse" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        auto second_value = std::string(subkey, pos+1);
-        params.start.row = std::stod(second_value);
-        analyze_arg(nargs-1, &args[1], params);
-        return;
-    }
-}
-
-ParamsType parse_arguments(int nargs, char* args[])
-{
-    if (nargs == 0) return {};
-    if ((std::string(args[0]) == "--help"s) || (std::string(args[0]) == "-h"))
-    {
-        std::cout << 
-R"RAW(Usage : simulation [option(s)]
-  Lance la simulation d'incendie en prenant en compte les [option(s)].
-  Les options sont :
-    -l, --longueur=LONGUEUR     Définit la taille LONGUEUR (réel en km) du carré représentant la carte de la végétation.
-    -n, --number_of_cases=N     Nombre n de cases par direction pour la discrétisation
-    -w, --wind=VX,VY            Définit le vecteur vitesse du vent (pas de vent par défaut).
-    -s, --start=COL,ROW         Définit les indices I,J de la case où commence l'incendie (milieu de la carte par défaut)
-)RAW";
-        exit(EXIT_SUCCESS);
-    }
-    ParamsType params;
-    analyze_arg(nargs, args, params);
-    return params;
-}
-
-bool check_params(ParamsType& params)
-{
-    bool flag = true;
-    if (params.length <= 0)
-    {
-        std::cerr << "[ERREUR FATALE] La longueur du terrain doit être positive et non nulle !" << std::endl;
-        flag = false;
-    }
-
-    if (params.discretization <= 0)
-    {
-        std::cerr << "[ERREUR FATALE] Le nombre de cellules par direction doit être positive et non nulle !" << std::endl;
-        flag = false;
-    }
-
-    if ((params.start.row >= params.discretization) || (params.start.column >= params.discretization))
-    {
-        std::cerr << "[ERREUR FATALE] Mauvais indices pour la position initiale du foyer" << std::endl;
-        flag = false;
-    }
-    
-    return flag;
-}
-
-void display_params(ParamsType const& params)
-{
-    std::cout << "Parametres définis pour la simulation : \n"
-              << "\tTaille du terrain : " << params.length << std::endl 
-              << "\tNombre de cellules par direction : " << params.discretization << std::endl 
-              << "\tVecteur vitesse : [" << params.wind[0] << ", " << params.wind[1] << "]" << std::endl
-              << "\tPosition initiale du foyer (col, ligne) : " << params.start.column << ", " << params.start.row << std::endl;
-}
-
-int main(int nargs, char* args[]) {
-    MPI_Init(&nargs, &args);
-    int rank, nbp;
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &nbp);
-
-    auto params = parse_arguments(nargs-1, &args[1]);
-    display_params(params);
-    if (!check_params(params)) return EXIT_FAILURE;
-
-    unsigned geometry = params.discretization;
-
-    Model simu(params.length, geometry, params.wind, params.start, rank, nbp);
-
-    std::chrono::time_point<std::chrono::high_resolution_clock> start_global, end_global;
-    double total_time_global = 0.0;
-    std::chrono::duration<double> total_time_iter{0};
-    int iteration_count = 0;
-
-    start_global = std::chrono::high_resolution_clock::now();
-
-    std::vector<int> recvcounts, displs;
-    std::vector<unsigned> local_rows(nbp), first_rows(nbp);
-    std::vector<std::uint8_t> vm_recv, fm_recv;
-    std::shared_ptr<Displayer> displayer;  
-    if (rank == 0) {
-        displayer = Displayer::init_instance(geometry, geometry);
-        unsigned N = geometry;
-        unsigned base_rows = N / nbp;
-        unsigned extra_rows = N % nbp;
-        unsigned offset = 0;
-        for (int p = 0; p < nbp; p++) {
-            local_rows[p] = base_rows + (static_cast<unsigned>(p) < extra_rows ? 1 : 0);
-            first_rows[p] = offset;
-            offset += local_rows[p];
-        }
-        recvcounts.resize(nbp);
-        displs.resize(nbp);
-        for (int p = 0; p < nbp; p++) {
-            recvcounts[p] = local_rows[p] * geometry;
-            displs[p] = first_rows[p] * geometry;
-        }
-        vm_recv.resize(geometry * geometry);
-        fm_recv.resize(geometry * geometry);
-    }
-
-    bool local_running = true, global_running = true;
-    while (global_running) {
-        auto start_iter = std::chrono::high_resolution_clock::now();
-        local_running = simu.update();
-
-        unsigned local_rows_p = simu.m_local_rows;
-        std::vector<std::uint8_t> local_vm(simu.vegetal_map().begin() + geometry,
-                                          simu.vegetal_map().begin() + (local_rows_p + 1) * geometry);
-        std::vector<std::uint8_t> local_fm(simu.fire_map().begin() + geometry,
-                                          simu.fire_map().begin() + (local_rows_p + 1) * geometry);
-
-        if (rank == 0) {
-            MPI_Gatherv(local_vm.data(), local_vm.size(), MPI_UINT8_T,
-                       vm_recv.data(), recvcounts.data(), displs.data(), MPI_UINT8_T,
-                       0, MPI_COMM_WORLD);
-            MPI_Gatherv(local_fm.data(), local_fm.size(), MPI_UINT8_T,
-                       fm_recv.data(), recvcounts.data(), displs.data(), MPI_UINT8_T,
-                       0, MPI_COMM_WORLD);
-            displayer->update(vm_recv, fm_recv);
-        } else {
-            MPI_Gatherv(local_vm.data(), local_vm.size(), MPI_UINT8_T,
-                       nullptr, nullptr, nullptr, MPI_UINT8_T,
-                       0, MPI_COMM_WORLD);
-            MPI_Gatherv(local_fm.data(), local_fm.size(), MPI_UINT8_T,
-                       nullptr, nullptr, nullptr, MPI_UINT8_T,
-                       0, MPI_COMM_WORLD);
-        }
-
-        MPI_Allreduce(&local_running, &global_running, 1, MPI_CXX_BOOL, MPI_LOR, MPI_COMM_WORLD);
-
-        auto end_iter = std::chrono::high_resolution_clock::now();
-        total_time_iter += end_iter - start_iter;
-        iteration_count++;
-    }
-
-    end_global = std::chrono::high_resolution_clock::now();
-    total_time_global = std::chrono::duration<double>(end_global - start_global).count();
-
-    if (rank == 0) {
-        double avg_iter_time = total_time_iter.count() / iteration_count;
-        std::cout << "Temps global (rang " << rank << ") : " << total_time_global << " secondes\n";
-        std::cout << "Temps moyen par itération : " << avg_iter_time << " secondes\n";
-    }
-
-    MPI_Finalize();
-    return EXIT_SUCCESS;
+#include <string>
+#include <cstdlib>
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <algorithm>
+#include <mpi.h>
+
+#include "model.hpp"
+#include "display.hpp"
+#include "lod.hpp"
+#include "merkle.hpp"
+
+using namespace std::string_literals;
+using namespace std::chrono_literals;
+
+struct ParamsType
+{
+    double length{1.};
+    unsigned discretization{20u};
+    std::array<double,2> wind{0.,0.};
+    Model::LexicoIndices start{10u,10u};
+    bool digest{false};
+    std::string merkle_log{};
+    std::size_t batch{1};
+    unsigned viewport{1024u};
+};
+
+void analyze_arg(int nargs, char* args[], ParamsType& params)
+{
+    if (nargs == 0) return;
+    std::string key(args[0]);
+    if (key == "-l"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque une valeur pour la longueur du terrain !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        params.length = std::stoul(args[1]);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    auto pos = key.find("--longueur=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+11);
+        params.length = std::stoul(subkey);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-n"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque une valeur pour le nombre de cases par direction pour la discrétisation du terrain !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        params.discretization = std::stoul(args[1]);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--number_of_cases=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+18);
+        params.discretization = std::stoul(subkey);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-w"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque une paire de valeurs pour la direction du vent !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        std::string values = std::string(args[1]);
+        params.wind[0] = std::stod(values);
+        auto pos = values.find(",");
+        if (pos == values.size())
+        {
+            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la vitesse" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        auto second_value = std::string(values, pos+1);
+        params.wind[1] = std::stod(second_value);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--wind=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+7);
+        params.wind[0] = std::stoul(subkey);
+        auto pos = subkey.find(",");
+        if (pos == subkey.size())
+        {
+            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la vitesse" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        auto second_value = std::string(subkey, pos+1);
+        params.wind[1] = std::stod(second_value);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-s"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque une paire de valeurs pour la position du foyer initial !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        std::string values = std::string(args[1]);
+        params.start.column = std::stod(values);
+        auto pos = values.find(",");
+        if (pos == values.size())
+        {
+            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la position du foyer initial" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        auto second_value = std::string(values, pos+1);
+        params.start.row = std::stod(second_value);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--start=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+8);
+        params.start.column = std::stoul(subkey);
+        auto pos = subkey.find(",");
+        if (pos == subkey.size())
+        {
+            std::cerr << "Doit fournir deux valeurs séparées par une virgule pour définir la vitesse" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        auto second_value = std::string(subkey, pos+1);
+        params.start.row = std::stod(second_value);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-v"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque la taille maximale de la fenêtre en pixels !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        params.viewport = std::stoul(args[1]);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--viewport=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+11);
+        params.viewport = std::stoul(subkey);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if ((key == "-d"s) || (key == "--digest"s))
+    {
+        params.digest = true;
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-a"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque le nombre de pas de temps calculés entre deux affichages !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        params.batch = std::stoul(args[1]);
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--advance=");
+    if (pos < key.size())
+    {
+        auto subkey = std::string(key, pos+10);
+        params.batch = std::stoul(subkey);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+
+    if (key == "-m"s)
+    {
+        if (nargs < 2)
+        {
+            std::cerr << "Manque le nom du journal de Merkle !" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        params.merkle_log = args[1];
+        analyze_arg(nargs-2, &args[2], params);
+        return;
+    }
+    pos = key.find("--merkle=");
+    if (pos < key.size())
+    {
+        params.merkle_log = std::string(key, pos+9);
+        analyze_arg(nargs-1, &args[1], params);
+        return;
+    }
+}
+
+ParamsType parse_arguments(int nargs, char* args[])
+{
+    if (nargs == 0) return {};
+    if ((std::string(args[0]) == "--help"s) || (std::string(args[0]) == "-h"))
+    {
+        std::cout << 
+R"RAW(Usage : simulation [option(s)]
+  Lance la simulation d'incendie en prenant en compte les [option(s)].
+  Les options sont :
+    -l, --longueur=LONGUEUR     Définit la taille LONGUEUR (réel en km) du carré représentant la carte de la végétation.
+    -n, --number_of_cases=N     Nombre n de cases par direction pour la discrétisation
+    -w, --wind=VX,VY            Définit le vecteur vitesse du vent (pas de vent par défaut).
+    -s, --start=COL,ROW         Définit les indices I,J de la case où commence l'incendie (milieu de la carte par défaut)
+    -d, --digest                Affiche à chaque pas l'empreinte incrémentale des cartes (somme sur les processus)
+    -m, --merkle=FICHIER        Écrit à chaque pas l'arbre de Merkle des tuiles des cartes dans FICHIER (à comparer
+                                avec merkle_diff)
+    -a, --advance=K             Calcule K pas de temps d'affilée entre deux affichages (1 par défaut) ; empreinte,
+                                journal de Merkle et test d'arrêt ne sont alors faits qu'à la fin de chaque lot
+    -v, --viewport=PIXELS       Taille maximale de la fenêtre (1024 par défaut) : une carte plus grande y est montrée
+                                réduite ; touches + et - (zoom), flèches (déplacement), 0 (carte entière)
+)RAW";
+        exit(EXIT_SUCCESS);
+    }
+    ParamsType params;
+    analyze_arg(nargs, args, params);
+    return params;
+}
+
+bool check_params(ParamsType& params)
+{
+    bool flag = true;
+    if (params.length <= 0)
+    {
+        std::cerr << "[ERREUR FATALE] La longueur du terrain doit être positive et non nulle !" << std::endl;
+        flag = false;
+    }
+
+    if (params.discretization <= 0)
+    {
+        std::cerr << "[ERREUR FATALE] Le nombre de cellules par direction doit être positive et non nulle !" << std::endl;
+        flag = false;
+    }
+
+    if (params.batch == 0)
+    {
+        std::cerr << "[ERREUR FATALE] Le nombre de pas de temps entre deux affichages doit être non nul !" << std::endl;
+        flag = false;
+    }
+
+    if (params.viewport == 0)
+    {
+        std::cerr << "[ERREUR FATALE] La taille de la fenêtre doit être non nulle !" << std::endl;
+        flag = false;
+    }
+
+    if ((params.start.row >= params.discretization) || (params.start.column >= params.discretization))
+    {
+        std::cerr << "[ERREUR FATALE] Mauvais indices pour la position initiale du foyer" << std::endl;
+        flag = false;
+    }
+    
+    return flag;
+}
+
+void display_params(ParamsType const& params)
+{
+    std::cout << "Parametres définis pour la simulation : \n"
+              << "\tTaille du terrain : " << params.length << std::endl 
+              << "\tNombre de cellules par direction : " << params.discretization << std::endl 
+              << "\tVecteur vitesse : [" << params.wind[0] << ", " << params.wind[1] << "]" << std::endl
+              << "\tPosition initiale du foyer (col, ligne) : " << params.start.column << ", " << params.start.row << std::endl
+              << "\tEmpreinte incrémentale : " << (params.digest ? "oui" : "non") << std::endl
+              << "\tPas de temps entre deux affichages : " << params.batch << std::endl
+              << "\tTaille maximale de la fenêtre : " << params.viewport << std::endl;
+}
+
+int main(int nargs, char* args[]) {
+    MPI_Init(&nargs, &args);
+    int rank, nbp;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nbp);
+
+    auto params = parse_arguments(nargs-1, &args[1]);
+    display_params(params);
+    if (!check_params(params)) return EXIT_FAILURE;
+
+    unsigned geometry = params.discretization;
+
+    Model simu(params.length, geometry, params.wind, params.start, rank, nbp);
+
+    std::chrono::time_point<std::chrono::high_resolution_clock> start_global, end_global;
+    double total_time_global = 0.0;
+    std::chrono::duration<double> total_time_iter{0};
+    int iteration_count = 0;
+
+    start_global = std::chrono::high_resolution_clock::now();
+
+    std::shared_ptr<Displayer> displayer;  
+    std::ofstream merkle_log;
+    if ((rank == 0) && !params.merkle_log.empty()) {
+        merkle_log.open(params.merkle_log);
+        if (!merkle_log) {
+            std::cerr << "[ERREUR FATALE] Impossible de créer le journal " << params.merkle_log << std::endl;
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+    }
+    unsigned nb_tiles = merkle::tiles_per_side(geometry);
+    std::vector<std::uint64_t> leaves, global_leaves;
+    // fenêtre de la taille de la carte, au plus viewport x viewport pixels : chaque processus réduit ses lignes de
+    // la partie visible (voir lod.hpp) et le processus 0 ne reçoit que l'image réduite, combinée par MPI_Reduce
+    unsigned window = std::min(geometry, params.viewport);
+    Viewport viewport(window, window);
+    viewport.set_map(geometry, geometry);
+    std::vector<std::uint32_t> vegetation_sums;
+    std::vector<std::uint8_t> vegetation_image, fire_image;
+    SDL_Event event;
+    if (rank == 0) {
+        displayer = Displayer::init_instance(window, window);
+        displayer->viewport().set_map(geometry, geometry);
+    }
+
+    // avec -a K, chaque processus calcule K pas d'affilée (Model::advance) : les échanges de fantômes restent à
+    // chaque pas, mais réductions, rassemblement des cartes et affichage n'ont lieu qu'une fois par lot
+    std::vector<Model::StepSummary> summaries;
+    std::vector<unsigned long long> fronts, global_fronts;
+    std::size_t termination_step = 0; // premier pas où plus aucune case n'est en feu (processus 0, avec -a K)
+
+    bool local_running = true, global_running = true;
+    while (global_running) {
+        auto start_iter = std::chrono::high_resolution_clock::now();
+        if (params.batch == 1) {
+            local_running = simu.update();
+        } else {
+            summaries.clear();
+            local_running = simu.advance(params.batch, summaries);
+            // fronts de tous les processus à chaque pas du lot, en une seule réduction
+            fronts.resize(summaries.size());
+            global_fronts.resize(summaries.size());
+            for (std::size_t i = 0; i < summaries.size(); ++i) {
+                fronts[i] = summaries[i].front_size;
+            }
+            MPI_Reduce(fronts.data(), global_fronts.data(), int(fronts.size()), MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0,
+                       MPI_COMM_WORLD);
+            for (std::size_t i = 0; (rank == 0) && (termination_step == 0) && (i < summaries.size()); ++i) {
+                if (global_fronts[i] == 0) {
+                    termination_step = summaries[i].time_step;
+                }
+            }
+        }
+        if (params.digest) {
+            std::uint64_t local_digest = simu.digest(), digest = 0;
+            MPI_Reduce(&local_digest, &digest, 1, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+            if (rank == 0) {
+                char text[17];
+                std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(digest));
+                std::cout << "Empreinte à t=" << simu.time_step() << ": " << text << std::endl;
+            }
+        }
+
+        // lignes propres au processus, lues en place dans les cartes du modèle
+        MapView local_vm = simu.vegetal_view(), local_fm = simu.fire_view();
+
+        if (!params.merkle_log.empty()) {
+            // chaque processus calcule les feuilles de ses lignes, le processus 0 additionne et écrit l'arbre
+            leaves.assign(std::size_t(nb_tiles) * nb_tiles, 0u);
+            global_leaves.resize(leaves.size());
+            merkle::accumulate_leaves(local_fm, local_vm, geometry, simu.first_row(), leaves);
+            MPI_Reduce(leaves.data(), global_leaves.data(), int(leaves.size()), MPI_UINT64_T, MPI_SUM, 0,
+                       MPI_COMM_WORLD);
+            if (rank == 0) {
+                merkle::write_step(merkle_log, simu.time_step(), geometry, global_leaves);
+            }
+        }
+
+        // point de vue du processus 0 (zoom et déplacement au clavier), diffusé pour que tous réduisent la même région
+        Viewport::State view = (rank == 0 ? displayer->viewport().state() : Viewport::State{});
+        MPI_Bcast(view.data(), int(view.size()), MPI_INT, 0, MPI_COMM_WORLD);
+        viewport.set_state(view);
+        lod::Region region = viewport.region();
+        int nb_cells = int(region.rows * region.columns);
+        vegetation_sums.assign(nb_cells, 0u);
+        fire_image.assign(nb_cells, 0u);
+        lod::accumulate(local_vm, local_fm, simu.first_row(), region, vegetation_sums.data(), fire_image.data());
+        if (rank == 0) {
+            MPI_Reduce(MPI_IN_PLACE, vegetation_sums.data(), nb_cells, MPI_UINT32_T, MPI_SUM, 0, MPI_COMM_WORLD);
+            MPI_Reduce(MPI_IN_PLACE, fire_image.data(), nb_cells, MPI_UINT8_T, MPI_MAX, 0, MPI_COMM_WORLD);
+            vegetation_image.resize(nb_cells);
+            lod::average(region, geometry, geometry, vegetation_sums.data(), vegetation_image.data());
+            displayer->update(region, MapView(vegetation_image.data(), region.rows, region.columns, region.columns),
+                              MapView(fire_image.data(), region.rows, region.columns, region.columns));
+            if (SDL_PollEvent(&event)) {
+                displayer->handle_event(event);
+            }
+        } else {
+            MPI_Reduce(vegetation_sums.data(), nullptr, nb_cells, MPI_UINT32_T, MPI_SUM, 0, MPI_COMM_WORLD);
+            MPI_Reduce(fire_image.data(), nullptr, nb_cells, MPI_UINT8_T, MPI_MAX, 0, MPI_COMM_WORLD);
+        }
+
+        MPI_Allreduce(&local_running, &global_running, 1, MPI_CXX_BOOL, MPI_LOR, MPI_COMM_WORLD);
+
+        auto end_iter = std::chrono::high_resolution_clock::now();
+        total_time_iter += end_iter - start_iter;
+        iteration_count++;
+    }
+
+    end_global = std::chrono::high_resolution_clock::now();
+    total_time_global = std::chrono::duration<double>(end_global - start_global).count();
+
+    unsigned long long local_burnt = simu.burnt_cells(), burnt = 0;
+    MPI_Reduce(&local_burnt, &burnt, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        std::cout << "Dernier pas de temps : " << (termination_step > 0 ? termination_step : simu.time_step())
+                  << " (" << burnt << " cases touchées par le feu)" << std::endl;
+        double avg_iter_time = total_time_iter.count() / iteration_count;
+        std::cout << "Temps global (rang " << rank << ") : " << total_time_global << " secondes\n";
+        std::cout << "Temps moyen par itération : " << avg_iter_time << " secondes\n";
+    }
+
+    MPI_Finalize();
+    return EXIT_SUCCESS;
 }
\ No newline at end of file
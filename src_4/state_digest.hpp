@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Empreinte de l'état de la simulation tenue à jour au fil des écritures dans les cartes.
+ *
+ * L'empreinte est la somme (modulo 2^64) d'une clé par case et par carte, calculée à partir de l'indice de la case
+ * dans la carte globale et de sa valeur ; une valeur nulle ne contribue pas. Changer la valeur d'une case coûte O(1)
+ * (on retire l'ancienne clé et on ajoute la nouvelle), et la somme ne dépend ni de l'ordre des écritures ni du
+ * découpage de la carte : les empreintes partielles des threads ou des processus s'additionnent.
+ */
+namespace state_digest
+{
+    enum Layer : std::uint64_t { Fire = 0, Vegetation = 1 };
+
+    inline std::uint64_t key( Layer t_layer, std::size_t t_index, std::uint8_t t_value )
+    {
+        if (t_value == 0)
+            return 0u;
+        // Mélange de splitmix64
+        std::uint64_t x = ((std::uint64_t(t_index) << 9) | (std::uint64_t(t_layer) << 8) | t_value)
+                        + 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    // Variation de l'empreinte quand la case t_index passe de t_old à t_new
+    inline std::uint64_t change( Layer t_layer, std::size_t t_index, std::uint8_t t_old, std::uint8_t t_new )
+    {
+        return key(t_layer, t_index, t_new) - key(t_layer, t_index, t_old);
+    }
+}
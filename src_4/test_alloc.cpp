@@ -0,0 +1,77 @@
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <mpi.h>
+
+#include "model.hpp"
+
+// vérifie qu'un pas de temps n'alloue aucune mémoire : l'opérateur new global est remplacé par un compteur, et une
+// carte 2048 x 2048 répartie sur les processus fait un pas de mise en route puis 1000 pas comptés. Échoue si l'un des
+// pas comptés alloue sur l'un des processus (les allocations internes de MPI passent par malloc et ne comptent pas).
+namespace {
+    std::atomic<bool> counting{false};
+    std::atomic<std::size_t> allocations{0};
+
+    void* allocate(std::size_t t_size) {
+        if (counting.load(std::memory_order_relaxed)) {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (void* pointer = std::malloc(t_size == 0 ? 1 : t_size)) {
+            return pointer;
+        }
+        throw std::bad_alloc();
+    }
+
+    void* allocate(std::size_t t_size, std::nothrow_t const&) noexcept {
+        try {
+            return allocate(t_size);
+        } catch (std::bad_alloc const&) {
+            return nullptr;
+        }
+    }
+
+    constexpr unsigned discretization = 2048;
+    constexpr std::size_t nb_steps = 1000;
+}
+
+void* operator new(std::size_t t_size) { return allocate(t_size); }
+void* operator new[](std::size_t t_size) { return allocate(t_size); }
+void* operator new(std::size_t t_size, std::nothrow_t const& t_tag) noexcept { return allocate(t_size, t_tag); }
+void* operator new[](std::size_t t_size, std::nothrow_t const& t_tag) noexcept { return allocate(t_size, t_tag); }
+void operator delete(void* t_pointer) noexcept { std::free(t_pointer); }
+void operator delete[](void* t_pointer) noexcept { std::free(t_pointer); }
+void operator delete(void* t_pointer, std::size_t) noexcept { std::free(t_pointer); }
+void operator delete[](void* t_pointer, std::size_t) noexcept { std::free(t_pointer); }
+
+int main(int nargs, char* args[]) {
+    MPI_Init(&nargs, &args);
+    int rank, nbp;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nbp);
+
+    unsigned long long local_count = 0, count = 0;
+    {
+        Model simu(1., discretization, {5., 5.}, {discretization / 2, discretization / 2}, rank, nbp);
+        // le feu est éteint quand plus aucun processus n'a de case en feu
+        auto step = [&simu]() {
+            bool local_running = simu.update(), global_running = false;
+            MPI_Allreduce(&local_running, &global_running, 1, MPI_CXX_BOOL, MPI_LOR, MPI_COMM_WORLD);
+            return global_running;
+        };
+        step();
+        allocations = 0;
+        counting = true;
+        for (std::size_t i = 0; (i < nb_steps) && step(); ++i)
+            ;
+        counting = false;
+        local_count = allocations;
+    }
+    MPI_Allreduce(&local_count, &count, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    if (rank == 0) {
+        std::cout << count << " allocation(s) en " << nb_steps << " pas de temps (" << nbp << " processus)"
+                  << std::endl;
+    }
+    MPI_Finalize();
+    return count > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}